@@ -0,0 +1,296 @@
+/**
+ * @file bench.c
+ * @author Edgar Casal ()
+ * @version 0.1
+ * @date 2025-03-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Medição dos tempos das operações principais sobre mapas gerados aleatoriamente.
+ * Uso: ./bench [tamanho] [densidade] [desvio] [repeticoes] [semente]
+ *  - tamanho: linhas e colunas do mapa (sem este argumento é medida uma série de 64 até 2048)
+ *  - densidade: fração das posições com antena (por omissão 0.01)
+ *  - desvio: 0 = todas as frequências igualmente prováveis; perto de 1 = quase todas as antenas
+ *    com a primeira frequência (cada frequência tem (1 - desvio) vezes a probabilidade da anterior)
+ *  - repeticoes: número de medições de cada operação (por omissão 3)
+ * O resultado é escrito em CSV no stdout, uma linha por operação e tamanho.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "funcoes.h"
+
+#define MAPA_BENCH "bench_mapa.txt"
+#define BINARIO_BENCH "bench_antenas.bin"
+#define LIMITE_LISTA 5000       //Acima deste número de posições com efeito nefasto a versão com lista ordenada não é medida
+
+/// @brief Parâmetros de um mapa gerado
+typedef struct ConfigBench {
+    int linhas, colunas;
+    double densidade;
+    double desvio;
+    int repeticoes;
+    long antenas;           //Número de antenas do mapa gerado
+}ConfigBench;
+
+/// @brief Gerador pseudo-aleatório xorshift64*, para os mapas serem iguais em todas as máquinas
+/// @param estado Estado do gerador (diferente de zero)
+/// @return Devolve um número entre 0 e 1
+static double aleatorio(uint64_t* estado) {
+    *estado ^= *estado >> 12;
+    *estado ^= *estado << 25;
+    *estado ^= *estado >> 27;
+    return (double)((*estado * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+/// @brief Gera um mapa aleatório e grava-o num ficheiro de texto
+/// @param nomeFicheiro Nome do ficheiro a criar
+/// @param c Parâmetros do mapa (o número de antenas é guardado em c->antenas)
+/// @param semente Estado do gerador pseudo-aleatório
+/// @return Devolve false se o ficheiro não abrir ou não conseguir alocar espaço
+static bool gerarMapa(const char* nomeFicheiro, ConfigBench* c, uint64_t* semente) {
+    const char* frequencias = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    double acumulado[NUM_FREQ], peso = 1.0, total = 0.0, r;
+    FILE* fp;
+    char* linha;
+    int k;
+
+    //Probabilidade acumulada de cada frequência, decrescendo em progressão geométrica
+    for (k = 0; k < NUM_FREQ; k++) {
+        total += peso;
+        acumulado[k] = total;
+        peso *= 1.0 - c->desvio;
+    }
+
+    fp = fopen(nomeFicheiro, "w");
+    linha = (char*)malloc((size_t)c->colunas + 1);
+    if (fp == NULL || linha == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        free(linha);
+        return false;
+    }
+
+    c->antenas = 0;
+    for (int x = 0; x < c->linhas; x++) {
+        for (int y = 0; y < c->colunas; y++) {
+            linha[y] = '.';
+            if (aleatorio(semente) < c->densidade) {
+                r = aleatorio(semente) * total;
+                for (k = 0; k < NUM_FREQ - 1 && acumulado[k] < r; k++);
+                linha[y] = frequencias[k];
+                c->antenas++;
+            }
+        }
+        linha[c->colunas] = '\n';
+        fwrite(linha, 1, (size_t)c->colunas + 1, fp);
+    }
+
+    free(linha);
+    fclose(fp);
+    return true;
+}
+
+/// @brief Escreve uma linha do CSV com o melhor tempo e o tempo médio das repetições de uma operação
+/// @param c Parâmetros do mapa
+/// @param operacao Nome da operação medida
+/// @param tempos Tempo de cada repetição, em segundos
+/// @param resultado Valor devolvido pela operação (para confirmar que todas as versões calculam o mesmo)
+static void registar(const ConfigBench* c, const char* operacao, const double* tempos, long resultado) {
+    double melhor = tempos[0], soma = 0.0;
+
+    for (int i = 0; i < c->repeticoes; i++) {
+        soma += tempos[i];
+        if (tempos[i] < melhor) {
+            melhor = tempos[i];
+        }
+    }
+    printf("1,%s,%d,%d,%ld,%.4f,%.2f,%d,%.6f,%.6f,%ld\n", operacao, c->linhas, c->colunas, c->antenas,
+           c->densidade, c->desvio, c->repeticoes, melhor, soma / c->repeticoes, resultado);
+    fflush(stdout);
+}
+
+/// @brief Mede todas as operações sobre o mapa gravado em MAPA_BENCH
+/// @param c Parâmetros do mapa
+/// @param tempos Vetor com c->repeticoes posições para os tempos
+static void medirOperacoes(const ConfigBench* c, double* tempos) {
+    Antena* lista;
+    Antena* aux;
+    Mapa* mapa;
+    Nefasto* nefastos;
+    GrelhaBits* grelha;
+    TabelaAntenas* tabela;
+    FILE* fp;
+    long resultado = 0;
+    double inicio;
+    int i;
+
+    //Leitura do mapa para uma lista ligada (a lista é libertada fora da medição)
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        lista = carregarAntenas(MAPA_BENCH);
+        tempos[i] = tempoMonotonico() - inicio;
+        for (resultado = 0; lista != NULL; resultado++) {
+            aux = lista;
+            lista = lista->prox;
+            free(aux);
+        }
+    }
+    registar(c, "carregarAntenas", tempos, resultado);
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        mapa = carregarMapa(MAPA_BENCH);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = (mapa != NULL) ? mapa->poolAntenas.emUso : -1;
+        libertarMapa(mapa);
+    }
+    registar(c, "carregarMapa", tempos, resultado);
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        tabela = carregarTabelaAntenas(MAPA_BENCH);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = (tabela != NULL) ? tabela->n : -1;
+        libertarTabelaAntenas(tabela);
+    }
+    registar(c, "carregarTabelaAntenas", tempos, resultado);
+
+    mapa = carregarMapa(MAPA_BENCH);
+    if (mapa == NULL) {
+        return;
+    }
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        grelha = efeitoNefastoGrelha(mapa);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = contarGrelhaBits(grelha);
+        libertarGrelhaBits(grelha);
+    }
+    registar(c, "efeitoNefastoGrelha", tempos, resultado);
+
+    //A lista de efeitos nefastos é mantida ordenada (inserção em O(n)), por isso só é medida com poucas posições
+    if (resultado <= LIMITE_LISTA) {
+        for (i = 0; i < c->repeticoes; i++) {
+            inicio = tempoMonotonico();
+            nefastos = efeitoNefasto(mapa);
+            tempos[i] = tempoMonotonico() - inicio;
+            resultado = 0;
+            for (Nefasto* n = nefastos; n != NULL; n = n->prox) {
+                resultado++;
+            }
+            libertarNefasto(mapa, nefastos);
+        }
+        registar(c, "efeitoNefasto", tempos, resultado);
+    }
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        grelha = efeitoNefastoParalelo(mapa, 0);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = contarGrelhaBits(grelha);
+        libertarGrelhaBits(grelha);
+    }
+    registar(c, "efeitoNefastoParalelo", tempos, resultado);
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        grelha = efeitoNefastoHarmonicos(mapa, 0);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = contarGrelhaBits(grelha);
+        libertarGrelhaBits(grelha);
+    }
+    registar(c, "efeitoNefastoHarmonicos", tempos, resultado);
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        resultado = processarMapaEmBandas(MAPA_BENCH, NULL, 0);
+        tempos[i] = tempoMonotonico() - inicio;
+    }
+    registar(c, "processarMapaEmBandas", tempos, resultado);
+
+    //A impressão é medida para um ficheiro temporário, para não encher o terminal
+    grelha = efeitoNefastoGrelha(mapa);
+    for (i = 0; i < c->repeticoes; i++) {
+        fp = tmpfile();
+        inicio = tempoMonotonico();
+        resultado = escreverAntenasNefasto(fp, mapa, NULL, grelha);
+        if (fp != NULL) {
+            fflush(fp);
+        }
+        tempos[i] = tempoMonotonico() - inicio;
+        if (fp != NULL) {
+            fclose(fp);
+        }
+    }
+    registar(c, "imprimirAntenasNefasto", tempos, resultado);
+    libertarGrelhaBits(grelha);
+
+    lista = carregarAntenas(MAPA_BENCH);
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        resultado = gravarFicheiroBinario(BINARIO_BENCH, lista);
+        tempos[i] = tempoMonotonico() - inicio;
+    }
+    registar(c, "gravarFicheiroBinario", tempos, resultado);
+    while (lista != NULL) {
+        aux = lista;
+        lista = lista->prox;
+        free(aux);
+    }
+
+    libertarMapa(mapa);
+    remove(BINARIO_BENCH);
+}
+
+int main(int argc, char* argv[]) {
+    ConfigBench c;
+    uint64_t semente;
+    double* tempos;
+    int tamanho, primeiro, ultimo;
+
+    tamanho = (argc > 1) ? atoi(argv[1]) : 0;
+    c.densidade = (argc > 2) ? atof(argv[2]) : 0.01;
+    c.desvio = (argc > 3) ? atof(argv[3]) : 0.0;
+    c.repeticoes = (argc > 4) ? atoi(argv[4]) : 3;
+    semente = (argc > 5) ? (uint64_t)strtoull(argv[5], NULL, 10) : 12345;
+    if (semente == 0) {
+        semente = 1;
+    }
+    if (c.repeticoes < 1) {
+        c.repeticoes = 1;
+    }
+    if (c.desvio < 0.0 || c.desvio >= 1.0) {
+        c.desvio = 0.0;
+    }
+
+    //Sem tamanho, mede uma série de mapas que duplicam de lado, para mostrar como cada operação escala
+    primeiro = (tamanho > 0) ? tamanho : 64;
+    ultimo = (tamanho > 0) ? tamanho : 2048;
+
+    tempos = (double*)malloc((size_t)c.repeticoes * sizeof(double));
+    if (tempos == NULL) {
+        return 1;
+    }
+
+    printf("fase,operacao,linhas,colunas,antenas,densidade,desvio,repeticoes,melhor_s,media_s,resultado\n");
+    for (int lado = primeiro; lado <= ultimo; lado *= 2) {
+        c.linhas = lado;
+        c.colunas = lado;
+        if (!gerarMapa(MAPA_BENCH, &c, &semente)) {
+            fprintf(stderr, "Erro ao gerar o mapa %dx%d\n", lado, lado);
+            free(tempos);
+            return 1;
+        }
+        medirOperacoes(&c, tempos);
+    }
+
+    //Com a instrumentação ativa (make bench ESTATISTICAS=1), os contadores de toda a execução vão para o stderr
+    mostrarEstatisticas(stderr);
+
+    remove(MAPA_BENCH);
+    free(tempos);
+    return 0;
+}
@@ -10,6 +10,195 @@
 
 #include "funcoes.h"
 #include "malloc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PARES_POR_TAREFA 65536      //Número aproximado de pares de antenas tratados por cada tarefa paralela
+#define CANDIDATOS_POR_TAREFA 64    //Número de candidatas avaliadas por cada tarefa de avaliarCandidatos
+
+/*
+* Instrumentação: com EDA_ESTATISTICAS definido (make ESTATISTICAS=1) as funções principais contam alocações,
+* passos nas listas, pares analisados e bytes de entrada/saída, e medem o tempo de cada fase.
+* Sem EDA_ESTATISTICAS as macros não geram código nenhum.
+* Os contadores são somados com operações atómicas porque também são atualizados pelas threads do cálculo paralelo;
+* os tempos só são medidos nas funções chamadas pela thread principal.
+*/
+/// @brief Devolve o instante atual de um relógio que nunca anda para trás
+/// @return Devolve o número de segundos desde um instante fixo
+double tempoMonotonico(void) {
+    struct timespec t;
+#ifdef _WIN32
+    timespec_get(&t, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &t);
+#endif
+    return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+#ifdef EDA_ESTATISTICAS
+static Estatisticas estatisticas;
+
+#define CONTAR(campo, n) __atomic_fetch_add(&estatisticas.campo, (long)(n), __ATOMIC_RELAXED)
+#define INICIAR_TEMPO(inicio) double inicio = tempoMonotonico()
+#define TERMINAR_TEMPO(inicio, fase) registarTempo((fase), (inicio))
+
+/// @brief Soma ao tempo de uma fase o tempo passado desde o início da chamada
+/// @param fase Fase medida
+/// @param inicio Instante em que a chamada começou
+static void registarTempo(FaseEstatistica fase, double inicio) {
+    estatisticas.segundos[fase] += tempoMonotonico() - inicio;
+    estatisticas.chamadas[fase]++;
+}
+#else
+#define CONTAR(campo, n) ((void)0)
+#define INICIAR_TEMPO(inicio) ((void)0)
+#define TERMINAR_TEMPO(inicio, fase) ((void)0)
+#endif
+
+/// @brief Copia o estado atual dos contadores da instrumentação
+/// @param e Apontador onde é copiado o estado (tudo a zero sem EDA_ESTATISTICAS)
+void obterEstatisticas(Estatisticas* e) {
+    if (e == NULL) {
+        return;
+    }
+#ifdef EDA_ESTATISTICAS
+    *e = estatisticas;
+#else
+    memset(e, 0, sizeof(*e));
+#endif
+}
+
+/// @brief Põe todos os contadores e tempos da instrumentação a zero
+void reiniciarEstatisticas(void) {
+#ifdef EDA_ESTATISTICAS
+    memset(&estatisticas, 0, sizeof(estatisticas));
+#endif
+}
+
+/// @brief Escreve os contadores e os tempos de cada fase, um valor por linha no formato "nome: valor"
+/// @param fp Ficheiro de saída (por exemplo stderr)
+void mostrarEstatisticas(FILE* fp) {
+    if (fp == NULL) {
+        return;
+    }
+#ifdef EDA_ESTATISTICAS
+    static const char* nomes[NUM_FASES_ESTATISTICA] = { "carregar", "nefasto", "bandas", "estado", "escrever", "gravar", "candidatos" };
+    Estatisticas e;
+
+    obterEstatisticas(&e);
+    fprintf(fp, "alocacoes: %ld\npassosLista: %ld\nparesComparados: %ld\nbytesLidos: %ld\nbytesEscritos: %ld\n",
+            e.alocacoes, e.passosLista, e.paresComparados, e.bytesLidos, e.bytesEscritos);
+    for (int i = 0; i < NUM_FASES_ESTATISTICA; i++) {
+        fprintf(fp, "fase.%s: %ld chamadas, %.6f s\n", nomes[i], e.chamadas[i], e.segundos[i]);
+    }
+#else
+    fprintf(fp, "estatisticas: desativadas (compilar com -DEDA_ESTATISTICAS)\n");
+#endif
+}
+
+#define POOL_BLOCO_INICIAL 64           //Elementos do primeiro bloco de uma pool
+#define POOL_BLOCO_MAXIMO 65536         //Os blocos duplicam de tamanho até este número de elementos
+#define POOL_CABECALHO ((sizeof(BlocoPool) + 15) & ~(size_t)15)    //Cabeçalho do bloco, alinhado a 16 bytes
+
+/// @brief Prepara uma pool vazia (nenhum bloco é alocado até ao primeiro pedido)
+/// @param p Apontador para a pool
+/// @param tamanho Tamanho de cada elemento em bytes
+void iniciarPool(Pool* p, size_t tamanho) {
+    //Cada elemento tem de conseguir guardar o apontador da lista de livres e manter o alinhamento dos seguintes
+    if (tamanho < sizeof(void*)) {
+        tamanho = sizeof(void*);
+    }
+    p->tamanho = (tamanho + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    p->porBloco = POOL_BLOCO_INICIAL;
+    p->blocos = NULL;
+    p->proximo = NULL;
+    p->restantes = 0;
+    p->livres = NULL;
+    p->emUso = 0;
+    p->pedidos = 0;
+    p->reutilizados = 0;
+    p->numBlocos = 0;
+    p->bytes = 0;
+}
+
+/// @brief Entrega um elemento da pool: primeiro da lista de livres, depois do bloco atual, alocando um bloco novo se preciso
+/// @param p Apontador para a pool
+/// @return Devolve um elemento por inicializar, ou NULL se não conseguir alocar espaço
+void* alocarPool(Pool* p) {
+    void* elemento;
+
+    p->pedidos++;
+    CONTAR(alocacoes, 1);
+
+    //Reutiliza um elemento devolvido
+    if (p->livres != NULL) {
+        elemento = p->livres;
+        p->livres = *(void**)elemento;
+        p->reutilizados++;
+        p->emUso++;
+        return elemento;
+    }
+
+    //O bloco atual acabou: aloca outro, com o dobro dos elementos do anterior
+    if (p->restantes == 0) {
+        size_t bytes = POOL_CABECALHO + (size_t)p->porBloco * p->tamanho;
+        BlocoPool* bloco = (BlocoPool*)malloc(bytes);
+        if (bloco == NULL) {
+            return NULL;
+        }
+        bloco->prox = p->blocos;
+        p->blocos = bloco;
+        p->proximo = (char*)bloco + POOL_CABECALHO;
+        p->restantes = p->porBloco;
+        p->numBlocos++;
+        p->bytes += bytes;
+        if (p->porBloco < POOL_BLOCO_MAXIMO) {
+            p->porBloco *= 2;
+        }
+    }
+
+    elemento = p->proximo;
+    p->proximo += p->tamanho;
+    p->restantes--;
+    p->emUso++;
+    return elemento;
+}
+
+/// @brief Devolve um elemento à pool, colocando-o no início da lista de livres
+/// @param p Apontador para a pool
+/// @param elemento Elemento entregue por alocarPool (pode ser NULL)
+void devolverPool(Pool* p, void* elemento) {
+    if (elemento != NULL) {
+        *(void**)elemento = p->livres;
+        p->livres = elemento;
+        p->emUso--;
+    }
+}
+
+/// @brief Liberta todos os blocos da pool de uma só vez, em O(número de blocos)
+/// @param p Apontador para a pool
+void destruirPool(Pool* p) {
+    BlocoPool* bloco;
+
+    while (p->blocos != NULL) {
+        bloco = p->blocos;
+        p->blocos = bloco->prox;
+        free(bloco);
+    }
+    iniciarPool(p, p->tamanho);
+}
 
 /// @brief Cria uma antena nova com frequência e coordenadas
 /// @param freq Tipo de frequência (Aa até Zz)
@@ -21,6 +210,7 @@ Antena * criarAntena (char freq, int x, int y) {
 
     //Aloca espaço para a nova antena
     nova = (Antena*)malloc(sizeof(Antena));
+    CONTAR(alocacoes, 1);
 
     // Se o alocamento de espaço foi criado, então cria a nova antena com a frequência e coordenadas
     if (nova != NULL) {
@@ -33,56 +223,359 @@ Antena * criarAntena (char freq, int x, int y) {
     return nova;
 }
 
-/// @brief Carrega os dados das antenas de um ficheiro de texto para uma lista ligada
-/// @param nomeficheiro Nome do ficheiro de texto que contém o mapa de antenas
-/// @return Devolve NULL se o arquivo não abrir/se não conseguir alocar espaço
-Antena* carregarAntenas(char* nomeFicheiro) {
-    FILE* fp;
-    char c;
-    Antena* h = NULL;
+/// @brief Cria um mapa vazio com as dimensões dadas
+/// @param linhas Número de linhas do mapa
+/// @param colunas Número de colunas do mapa
+/// @return Devolve o novo mapa sem antenas ou NULL se não conseguir alocar espaço
+Mapa* criarMapa(int linhas, int colunas) {
+    Mapa* mapa = (Mapa*)malloc(sizeof(Mapa));
+
+    if (mapa != NULL) {
+        mapa->linhas = linhas;
+        mapa->colunas = colunas;
+        mapa->antenas = NULL;
+        iniciarPool(&mapa->poolAntenas, sizeof(Antena));
+        iniciarPool(&mapa->poolNefastos, sizeof(Nefasto));
+    }
+    return mapa;
+}
+
+/// @brief Cria uma antena com a memória do mapa (as antenas da lista do mapa devem ser criadas assim, e não com criarAntena)
+/// @param mapa Apontador para o mapa
+/// @param freq Tipo de frequência
+/// @param x Coordenada x da nova antena
+/// @param y Coordenada y da nova antena
+/// @return Devolve a nova antena ou NULL se não conseguir alocar espaço
+Antena* criarAntenaMapa(Mapa* mapa, char freq, int x, int y) {
+    Antena* nova;
+
+    if (mapa == NULL) {
+        return NULL;
+    }
+
+    nova = (Antena*)alocarPool(&mapa->poolAntenas);
+    if (nova != NULL) {
+        nova->freq = freq;
+        nova->x = x;
+        nova->y = y;
+        nova->prox = NULL;
+    }
+    return nova;
+}
+
+/// @brief Remove uma antena da lista do mapa e devolve-a à memória do mapa
+/// @param mapa Apontador para o mapa
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @return Devolve false se a antena não existir
+bool removerAntenaMapa(Mapa* mapa, int x, int y) {
     Antena* aux;
+    Antena* anterior = NULL;
+
+    if (mapa == NULL) {
+        return false;
+    }
+
+    aux = mapa->antenas;
+    while (aux != NULL && (aux->x != x || aux->y != y)) {
+        anterior = aux;
+        aux = aux->prox;
+    }
+    if (aux == NULL) {
+        return false;
+    }
+
+    if (anterior == NULL) {
+        mapa->antenas = aux->prox;
+    } else {
+        anterior->prox = aux->prox;
+    }
+    devolverPool(&mapa->poolAntenas, aux);
+    return true;
+}
 
-    int x = 0;
-    int y = 0;
+/// @brief Registo compacto de uma antena lido do ficheiro, antes de ser colocado numa estrutura
+typedef struct RegistoAntena {
+    char freq;
+    int x, y;
+} RegistoAntena;
 
-    //Abre o ficheiro em modo de leitura
-    fp = fopen(nomeFicheiro, "r");
+/// @brief Coloca o conteúdo completo de um ficheiro em memória (mmap em POSIX, leitura num só bloco nos restantes sistemas)
+/// @param nomeFicheiro Nome do ficheiro a abrir
+/// @param tamanho Apontador onde é devolvido o número de bytes do ficheiro
+/// @return Devolve o início dos dados ou NULL se o ficheiro não abrir
+static char* mapearFicheiro(const char* nomeFicheiro, size_t* tamanho) {
+#ifdef _WIN32
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    char* dados;
+    long n;
 
-    //Verifica se não conseguiu abrir
     if (fp == NULL) {
         return NULL;
     }
+    fseek(fp, 0, SEEK_END);
+    n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    dados = (char*)malloc(n > 0 ? (size_t)n : 1);
+    if (dados == NULL || fread(dados, 1, (size_t)n, fp) != (size_t)n) {
+        free(dados);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *tamanho = (size_t)n;
+    return dados;
+#else
+    struct stat info;
+    char* dados;
+    int fd = open(nomeFicheiro, O_RDONLY);
 
-    //Percorre cada caractere até ao final do ficheiro
-    while ((c = fgetc(fp))!=EOF) {
-            //Se o caractere for uma letra, cria uma antena nova
-            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
-                aux = (Antena*)malloc(sizeof(Antena));
-                if (aux == NULL) {
-                    fclose(fp);
-                    return NULL;    //Se o ficheiro não alocar espaço devolve NULL depois de fechar o ficheiro
-                }
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    *tamanho = (size_t)info.st_size;
+
+    //Um ficheiro vazio não pode ser mapeado, mas é um mapa válido sem antenas
+    if (*tamanho == 0) {
+        close(fd);
+        return (char*)"";
+    }
+
+    dados = (char*)mmap(NULL, *tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  //O mapeamento continua válido depois de fechar o descritor
+    if (dados == MAP_FAILED) {
+        return NULL;
+    }
+    madvise(dados, *tamanho, MADV_SEQUENTIAL);
+    return dados;
+#endif
+}
+
+/// @brief Liberta os dados devolvidos por mapearFicheiro
+/// @param dados Início dos dados
+/// @param tamanho Número de bytes dos dados
+static void desmapearFicheiro(char* dados, size_t tamanho) {
+#ifdef _WIN32
+    (void)tamanho;
+    free(dados);
+#else
+    if (tamanho > 0) {
+        munmap(dados, tamanho);
+    }
+#endif
+}
+
+/// @brief Procura o primeiro byte diferente de '.' analisando 8 bytes de cada vez
+/// @param p Início da zona a analisar
+/// @param fim Fim (exclusivo) da zona a analisar
+/// @return Devolve o apontador para o primeiro byte diferente de '.', ou fim se não existir
+static const char* procurarNaoPonto(const char* p, const char* fim) {
+    const uint64_t pontos = 0x2E2E2E2E2E2E2E2EULL;     //Oito caracteres '.'
+    uint64_t v;
+
+    //Depois do XOR com os pontos, uma palavra a zero significa oito posições vazias seguidas
+    while (fim - p >= 8) {
+        memcpy(&v, p, 8);
+        v ^= pontos;
+        if (v != 0) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            return p + (__builtin_clzll(v) >> 3);
+#else
+            return p + (__builtin_ctzll(v) >> 3);
+#endif
+        }
+        p += 8;
+    }
+    while (p < fim && *p == '.') {
+        p++;
+    }
+    return p;
+}
+
+/// @brief Analisa o texto completo de um mapa e devolve as antenas num vetor de registos, pela ordem do ficheiro
+/// @param dados Texto do mapa
+/// @param tamanho Número de bytes do texto
+/// @param registos Apontador onde é devolvido o vetor de registos (a libertar com free)
+/// @param n Apontador onde é devolvido o número de registos
+/// @param linhas Apontador onde é devolvido o número de linhas do mapa
+/// @param colunas Apontador onde é devolvido o comprimento da maior linha
+/// @return Devolve false se não conseguir alocar espaço
+static bool lerRegistosMapa(const char* dados, size_t tamanho, RegistoAntena** registos, int* n, int* linhas, int* colunas) {
+    const char* fim = dados + tamanho;
+    const char* linha = dados;
+    const char* fimLinha;
+    const char* p;
+    RegistoAntena* v = NULL;
+    int capacidade = 0;
+    int x = 0, largura;
+    char c;
+
+    *n = 0;
+    *colunas = 0;
+
+    //Cada iteração trata uma linha; memchr encontra o fim da linha sem testar byte a byte
+    while (linha < fim) {
+        fimLinha = (const char*)memchr(linha, '\n', (size_t)(fim - linha));
+        if (fimLinha == NULL) {
+            fimLinha = fim;
+        }
 
-                aux->freq = c;
-                aux->x = x;
-                aux->y = y;
-                aux->prox = h;
-                h = aux;
+        //Os ficheiros criados em Windows terminam as linhas com "\r\n"
+        largura = (int)(fimLinha - linha);
+        if (largura > 0 && linha[largura - 1] == '\r') {
+            largura--;
+        }
+        if (largura > *colunas) {
+            *colunas = largura;
+        }
 
-                //Debug
-                //printf("%c = (%d,%d)\n", aux->freq, aux->x, aux->y);
+        //Salta as posições vazias em blocos e só analisa os restantes caracteres
+        p = procurarNaoPonto(linha, linha + largura);
+        while (p < linha + largura) {
+            c = *p;
+            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+                if (*n == capacidade) {
+                    capacidade = (capacidade == 0) ? 64 : capacidade * 2;
+                    RegistoAntena* novo = (RegistoAntena*)realloc(v, (size_t)capacidade * sizeof(RegistoAntena));
+                    if (novo == NULL) {
+                        free(v);
+                        return false;
+                    }
+                    v = novo;
+                }
+                v[*n].freq = c;
+                v[*n].x = x;
+                v[*n].y = (int)(p - linha);
+                (*n)++;
             }
+            p = procurarNaoPonto(p + 1, linha + largura);
+        }
 
-            //Se encontrar uma mudança de linha, incrementa 1 linha e volta a coluna ao 0
-            if (c == '\n') {
-                x++;
-                y=0;
-            } else {
-                y++;
+        x++;
+        linha = fimLinha + 1;
+    }
+
+    *linhas = x;
+    *registos = v;
+    return true;
+}
+
+/// @brief Lê um ficheiro de mapa para um vetor de registos (passo comum a carregarMapa e carregarAntenas)
+/// @param nomeFicheiro Nome do ficheiro de texto que contém o mapa de antenas
+/// @param registos Apontador onde é devolvido o vetor de registos (a libertar com free)
+/// @param n Apontador onde é devolvido o número de registos
+/// @param linhas Apontador onde é devolvido o número de linhas do mapa
+/// @param colunas Apontador onde é devolvido o comprimento da maior linha
+/// @return Devolve false se o ficheiro não abrir/se não conseguir alocar espaço
+static bool lerRegistosFicheiro(char* nomeFicheiro, RegistoAntena** registos, int* n, int* linhas, int* colunas) {
+    char* dados;
+    size_t tamanho;
+    bool ok;
+
+    //Coloca o ficheiro inteiro em memória, sem ler caractere a caractere
+    dados = mapearFicheiro(nomeFicheiro, &tamanho);
+    if (dados == NULL) {
+        return false;
+    }
+    CONTAR(bytesLidos, tamanho);
+
+    //Extrai todas as antenas e as dimensões numa única passagem pelo texto
+    ok = lerRegistosMapa(dados, tamanho, registos, n, linhas, colunas);
+    desmapearFicheiro(dados, tamanho);
+    return ok;
+}
+
+/// @brief Carrega o mapa de um ficheiro de texto, com as antenas numa lista ligada e as dimensões reais do mapa
+/// @param nomeFicheiro Nome do ficheiro de texto que contém o mapa de antenas
+/// @return Devolve o mapa lido, ou NULL se o ficheiro não abrir/se não conseguir alocar espaço
+Mapa* carregarMapa(char* nomeFicheiro) {
+    RegistoAntena* registos = NULL;
+    int n, linhas, colunas;
+    Mapa* mapa;
+    Antena* aux;
+
+    INICIAR_TEMPO(tempoInicio);
+
+    if (!lerRegistosFicheiro(nomeFicheiro, &registos, &n, &linhas, &colunas)) {
+        return NULL;
+    }
+
+    mapa = criarMapa(linhas, colunas);
+    if (mapa == NULL) {
+        free(registos);
+        return NULL;
+    }
+
+    //Cria a lista a partir dos registos, inserindo cada antena no início (como na leitura original)
+    for (int i = 0; i < n; i++) {
+        aux = criarAntenaMapa(mapa, registos[i].freq, registos[i].x, registos[i].y);
+        if (aux == NULL) {
+            free(registos);
+            libertarMapa(mapa);
+            return NULL;
+        }
+        aux->prox = mapa->antenas;
+        mapa->antenas = aux;
+    }
+
+    free(registos);
+    TERMINAR_TEMPO(tempoInicio, FASE_CARREGAR);
+    return mapa;   //Devolve o mapa completo
+}
+
+/// @brief Liberta a memória ocupada por um mapa, pelas suas antenas e pelos efeitos nefastos criados com a sua memória
+/// @param mapa Apontador para o mapa a libertar
+void libertarMapa(Mapa* mapa) {
+    if (mapa == NULL) {
+        return;
+    }
+
+    //Os nós estão nas pools do mapa: basta libertar os blocos, sem percorrer as listas
+    destruirPool(&mapa->poolAntenas);
+    destruirPool(&mapa->poolNefastos);
+    free(mapa);
+}
+
+/// @brief Carrega os dados das antenas de um ficheiro de texto para uma lista ligada
+/// @param nomeficheiro Nome do ficheiro de texto que contém o mapa de antenas
+/// @return Devolve NULL se o arquivo não abrir/se não conseguir alocar espaço (as antenas são criadas com criarAntena e libertadas com free)
+Antena* carregarAntenas(char* nomeFicheiro) {
+    RegistoAntena* registos = NULL;
+    int n, linhas, colunas;
+    Antena* h = NULL;
+    Antena* aux;
+
+    INICIAR_TEMPO(tempoInicio);
+
+    if (!lerRegistosFicheiro(nomeFicheiro, &registos, &n, &linhas, &colunas)) {
+        return NULL;
+    }
+
+    //Cria a lista diretamente a partir dos registos, pela mesma ordem que carregarMapa
+    for (int i = 0; i < n; i++) {
+        aux = criarAntena(registos[i].freq, registos[i].x, registos[i].y);
+        if (aux == NULL) {
+            //Não devolve uma lista incompleta: liberta as antenas já criadas
+            while (h != NULL) {
+                aux = h;
+                h = h->prox;
+                free(aux);
             }
-        }  
-    fclose(fp);
-    return h;   //Devolve a lista completa depois de fechar o ficheiro
+            free(registos);
+            return NULL;
+        }
+        aux->prox = h;
+        h = aux;
+    }
+
+    free(registos);
+    TERMINAR_TEMPO(tempoInicio, FASE_CARREGAR);
+    return h;
 }
 
 
@@ -107,6 +600,7 @@ Antena* inserirAntena (Antena* h, Antena* nova) {
     //Percorre a lista até encontrar a posição certa para inserir
     while (aux -> prox != NULL && (aux -> prox -> x < nova->x || (aux -> prox -> x == nova -> x && aux -> prox -> y < nova -> y))) {
         aux = aux -> prox;
+        CONTAR(passosLista, 1);
     }
     //Insere a nova antena na posição correta
     nova -> prox = aux -> prox;
@@ -142,6 +636,7 @@ Antena* removerAntena (Antena * h, int x, int y, bool *res) {
     while (aux != NULL && (aux->x != x || aux->y != y)) {
         aux2 = aux;
         aux = aux -> prox;
+        CONTAR(passosLista, 1);
     }
     
     //Se a antena não for encontrada, devolve a lista
@@ -187,6 +682,7 @@ bool gravarFicheiroBinario(char * nomeFicheiro, Antena* h) {
     Antena* aux = h;    //Apontador auxiliar (aux) que aponta para o início da lista (h)
 
     //Abre o ficheiro em modo de escrita binária
+    INICIAR_TEMPO(tempoInicio);
     FILE* fp = fopen(nomeFicheiro, "wb");
 
     //Se o ficheiro não for aberto devolve false
@@ -202,7 +698,9 @@ bool gravarFicheiroBinario(char * nomeFicheiro, Antena* h) {
         aux = aux->prox;
     }
 
+    CONTAR(bytesEscritos, ftell(fp));
     fclose(fp);
+    TERMINAR_TEMPO(tempoInicio, FASE_GRAVAR);
     return true;
 }
 
@@ -215,6 +713,7 @@ Nefasto* criarNefasto (int x, int y){
 
     //Alocamento de espaço para o novo efeito nefasto
     novo = (Nefasto*)malloc(sizeof(Nefasto));
+    CONTAR(alocacoes, 1);
 
     //Se for alocado corretamente, cria o novo efeito nefasto
     if (novo != NULL) {
@@ -227,6 +726,44 @@ Nefasto* criarNefasto (int x, int y){
     return novo;
 }
 
+/// @brief Cria um efeito nefasto com a memória do mapa
+/// @param mapa Apontador para o mapa
+/// @param x Coordenada x do novo efeito nefasto
+/// @param y Coordenada y do novo efeito nefasto
+/// @return Devolve o novo efeito nefasto ou NULL se não conseguir alocar espaço
+Nefasto* criarNefastoMapa(Mapa* mapa, int x, int y) {
+    Nefasto* novo;
+
+    if (mapa == NULL) {
+        return NULL;
+    }
+
+    novo = (Nefasto*)alocarPool(&mapa->poolNefastos);
+    if (novo != NULL) {
+        novo->x = x;
+        novo->y = y;
+        novo->prox = NULL;
+    }
+    return novo;
+}
+
+/// @brief Liberta uma lista de efeitos nefastos, devolvendo os nós à memória do mapa
+/// @param mapa Apontador para o mapa com cuja memória a lista foi criada (NULL se foi criada com criarNefasto)
+/// @param h Apontador para o início da lista
+void libertarNefasto(Mapa* mapa, Nefasto* h) {
+    Nefasto* aux;
+
+    while (h != NULL) {
+        aux = h;
+        h = h->prox;
+        if (mapa != NULL) {
+            devolverPool(&mapa->poolNefastos, aux);
+        } else {
+            free(aux);
+        }
+    }
+}
+
 /// @brief Insere um efeito nefasto novo numa lista ligada em forma ordenada
 /// @param h Apontador para o início da lista de efeitos nefasto
 /// @param novo Apontador para o novo efeito nefasto
@@ -248,6 +785,7 @@ Nefasto* inserirNefasto(Nefasto* h, Nefasto* novo) {
     //Percorre a lista até encontrar a posição certa para inserir
     while (aux -> prox != NULL && (aux -> prox -> x < novo->x || (aux -> prox -> x == novo -> x && aux -> prox -> y < novo -> y))) {
         aux = aux -> prox;
+        CONTAR(passosLista, 1);
     }
     //Insere a nova antena na posição correta
     novo -> prox = aux -> prox;
@@ -257,116 +795,1971 @@ Nefasto* inserirNefasto(Nefasto* h, Nefasto* novo) {
     return h;
 }
 
-/// @brief Calcula as posições com efeito nefasto baseado na lista de antenas existentes
+/// @brief Converte uma frequência no índice do seu grupo (A-Z: 0-25, a-z: 26-51, 0-9: 52-61)
+/// @param freq Frequência da antena
+/// @return Devolve o índice do grupo da frequência ou -1 se a frequência não for válida
+int indiceFrequencia(char freq) {
+    if (freq >= 'A' && freq <= 'Z') {
+        return freq - 'A';
+    }
+    if (freq >= 'a' && freq <= 'z') {
+        return 26 + (freq - 'a');
+    }
+    if (freq >= '0' && freq <= '9') {
+        return 52 + (freq - '0');
+    }
+    return -1;
+}
+
+/// @brief Acrescenta as coordenadas de uma antena ao fim de um grupo de frequência
+/// @param g Apontador para o grupo de frequência
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @return Devolve false se não conseguir alocar espaço
+bool adicionarAoGrupo(GrupoFrequencia* g, int x, int y) {
+    //Se os vetores estiverem cheios, duplica a capacidade
+    if (g->n == g->capacidade) {
+        int novaCapacidade = (g->capacidade == 0) ? 8 : g->capacidade * 2;
+        int* nx = (int*)realloc(g->x, novaCapacidade * sizeof(int));
+        if (nx == NULL) {
+            return false;
+        }
+        g->x = nx;
+        int* ny = (int*)realloc(g->y, novaCapacidade * sizeof(int));
+        if (ny == NULL) {
+            return false;
+        }
+        g->y = ny;
+        g->capacidade = novaCapacidade;
+    }
+
+    g->x[g->n] = x;
+    g->y[g->n] = y;
+    g->n++;
+    return true;
+}
+
+/// @brief Separa as antenas da lista em grupos, um por frequência, mantendo a ordem da lista dentro de cada grupo
 /// @param h Apontador para o início da lista de antenas
-/// @return Devolve uma lista ligada com todas as posições de efeitos nefastos encontradas
-Nefasto* efeitoNefasto (Antena* h) {
-    Nefasto* lista = NULL;
+/// @param f Apontador para os grupos a preencher (as antenas com frequência inválida são ignoradas)
+/// @return Devolve false se não conseguir alocar espaço
+bool agruparFrequencias(Antena* h, Frequencias* f) {
     Antena* aux = h;
-    Antena* aux2;
-    int x1, x2, y1, y2;
+    int i;
+
+    //Começa com todos os grupos vazios
+    for (i = 0; i < NUM_FREQ; i++) {
+        f->grupos[i].n = 0;
+        f->grupos[i].capacidade = 0;
+        f->grupos[i].x = NULL;
+        f->grupos[i].y = NULL;
+    }
 
-    //Percorre cada antena da lista
+    //Percorre a lista uma única vez e coloca cada antena no grupo da sua frequência
     while (aux != NULL) {
-        aux2 = aux->prox; //Começa a comparação com a próxima antena
-
-        while (aux2 != NULL) {
-            if (aux->freq == aux2->freq) {  //Verifica se as antenas têm a mesma frequência
-
-                /*
-                * Cálculo do ponto com efeito nefasto entre duas antenas com a mesma frequência:
-                * 
-                * Para um par de antenas A1 e A2, onde:
-                * - A1 está na posição (x1,y1)
-                * - A2 está na posição (x2,y2)
-                * 
-                * O efeito nefasto acontece em dois pontos:
-                * 1) Quando A1 está ao dobro da distância de A2:
-                *    Ponto = (2*x1 - x2, 2*y1 - y2)
-                * 2) Quando A2 está ao dobro da distância de A1:
-                *    Ponto = (2*x2 - x1, 2*y2 - y1)
-                */
-                x1 = 2 * aux->x - aux2->x;
-                y1 = 2 * aux->y - aux2->y;
-
-                x2 = 2 * aux2->x - aux->x;
-                y2 = 2 * aux2->y - aux->y;
-
-                //Verifica se 1) está dentro dos limites do mapa e chama a função inserirNefasto para adicionar o ponto à lista ligada
-                if (x1 >= 0 && y1 >= 0 && x1 < MAXi && y1 < MAXj) {
-                    lista = inserirNefasto(lista, criarNefasto(x1, y1));
-                }
-                //Verifica se 2) está dentro dos limites do mapa e chama a função inserirNefasto para adicionar o ponto à lista ligada  
-                if (x2 >= 0 && y2 >= 0 && x2 < MAXi && y2 < MAXj) {
-                    lista = inserirNefasto(lista, criarNefasto(x2, y2));
-                }
-            }
-            aux2 = aux2->prox;  //Avança para a próxima antena
-            
+        i = indiceFrequencia(aux->freq);
+        if (i >= 0 && !adicionarAoGrupo(&f->grupos[i], aux->x, aux->y)) {
+            libertarFrequencias(f);
+            return false;
         }
-        aux = aux->prox;    //Avança para a próxima antena principal
+        aux = aux->prox;
     }
-    return lista;   //Devolve a lista de efeitos nefastos
+    return true;
 }
 
-/// @brief Função que imprime as posições dos efeitos nefastos em forma tabular
-/// @param h Apontador para o início da lista de efeitos nefastos
-bool imprimirNefasto(Nefasto* h) {
-    Nefasto* aux = h;   //Apontador auxiliar (aux) que aponta para o início da lista (h)
+/// @brief Liberta a memória ocupada pelos grupos de frequência
+/// @param f Apontador para os grupos a libertar
+void libertarFrequencias(Frequencias* f) {
+    for (int i = 0; i < NUM_FREQ; i++) {
+        free(f->grupos[i].x);
+        free(f->grupos[i].y);
+        f->grupos[i].x = NULL;
+        f->grupos[i].y = NULL;
+        f->grupos[i].n = 0;
+        f->grupos[i].capacidade = 0;
+    }
+}
 
-    if (h == NULL) {
-        return false;
+/*
+* Cálculo do ponto com efeito nefasto entre duas antenas com a mesma frequência:
+* 
+* Para um par de antenas A1 e A2, onde:
+* - A1 está na posição (x1,y1)
+* - A2 está na posição (x2,y2)
+* 
+* O efeito nefasto acontece em dois pontos:
+* 1) Quando A1 está ao dobro da distância de A2:
+*    Ponto = (2*x1 - x2, 2*y1 - y2)
+* 2) Quando A2 está ao dobro da distância de A1:
+*    Ponto = (2*x2 - x1, 2*y2 - y1)
+*
+* calcularAntinodos aplica estas fórmulas a uma antena e a um vetor de antenas parceiras.
+* Com AVX2 são tratadas 8 parceiras de cada vez, com SSE2 4 de cada vez; os limites do mapa
+* são verificados com máscaras de comparação em vez de um if por ponto. Se nenhum conjunto
+* de instruções estiver disponível (ou se EDA_SEM_SIMD estiver definido) é usada a versão escalar.
+*/
+#if !defined(EDA_SEM_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_AVX2
+#elif !defined(EDA_SEM_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_SSE2
+#endif
+
+/// @brief Calcula os dois pontos de efeito nefasto entre uma antena e cada antena parceira, ficando só com os que estão dentro do mapa
+/// @param xa Coordenada x da antena de referência
+/// @param ya Coordenada y da antena de referência
+/// @param xs Coordenadas x das antenas parceiras
+/// @param ys Coordenadas y das antenas parceiras
+/// @param n Número de antenas parceiras
+/// @param mapa Apontador para o mapa com os limites
+/// @param rx Vetor onde são escritas as coordenadas x dos pontos (com espaço para 2*n pontos)
+/// @param ry Vetor onde são escritas as coordenadas y dos pontos (com espaço para 2*n pontos)
+/// @return Devolve o número de pontos escritos
+int calcularAntinodos(int xa, int ya, const int* xs, const int* ys, int n, const Mapa* mapa, int* rx, int* ry) {
+    int total = 0;
+    int j = 0;
+
+    CONTAR(paresComparados, n);
+
+#if defined(SIMD_AVX2)
+    const __m256i ax = _mm256_set1_epi32(xa), ay = _mm256_set1_epi32(ya);
+    const __m256i ax2 = _mm256_add_epi32(ax, ax), ay2 = _mm256_add_epi32(ay, ay);
+    const __m256i menosUm = _mm256_set1_epi32(-1);
+    const __m256i linhas = _mm256_set1_epi32(mapa->linhas), colunas = _mm256_set1_epi32(mapa->colunas);
+    int PX[16], PY[16];
+
+    for (; j + 8 <= n; j += 8) {
+        __m256i bx = _mm256_loadu_si256((const __m256i*)(xs + j));
+        __m256i by = _mm256_loadu_si256((const __m256i*)(ys + j));
+
+        //Ponto 1) = 2A - B e ponto 2) = 2B - A, para 8 parceiras em simultâneo
+        __m256i p1x = _mm256_sub_epi32(ax2, bx), p1y = _mm256_sub_epi32(ay2, by);
+        __m256i p2x = _mm256_sub_epi32(_mm256_add_epi32(bx, bx), ax);
+        __m256i p2y = _mm256_sub_epi32(_mm256_add_epi32(by, by), ay);
+
+        //Máscara com todos os bits ligados nas posições com 0 <= x < linhas e 0 <= y < colunas
+        __m256i m1 = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(p1x, menosUm), _mm256_cmpgt_epi32(linhas, p1x)),
+                                      _mm256_and_si256(_mm256_cmpgt_epi32(p1y, menosUm), _mm256_cmpgt_epi32(colunas, p1y)));
+        __m256i m2 = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(p2x, menosUm), _mm256_cmpgt_epi32(linhas, p2x)),
+                                      _mm256_and_si256(_mm256_cmpgt_epi32(p2y, menosUm), _mm256_cmpgt_epi32(colunas, p2y)));
+        int bits = _mm256_movemask_ps(_mm256_castsi256_ps(m1)) | (_mm256_movemask_ps(_mm256_castsi256_ps(m2)) << 8);
+
+        //Só os pontos dentro do mapa são copiados para a saída
+        if (bits != 0) {
+            _mm256_storeu_si256((__m256i*)PX, p1x);
+            _mm256_storeu_si256((__m256i*)(PX + 8), p2x);
+            _mm256_storeu_si256((__m256i*)PY, p1y);
+            _mm256_storeu_si256((__m256i*)(PY + 8), p2y);
+            while (bits != 0) {
+                int k = __builtin_ctz((unsigned)bits);
+                bits &= bits - 1;
+                rx[total] = PX[k];
+                ry[total] = PY[k];
+                total++;
+            }
+        }
     }
+#elif defined(SIMD_SSE2)
+    const __m128i ax = _mm_set1_epi32(xa), ay = _mm_set1_epi32(ya);
+    const __m128i ax2 = _mm_add_epi32(ax, ax), ay2 = _mm_add_epi32(ay, ay);
+    const __m128i menosUm = _mm_set1_epi32(-1);
+    const __m128i linhas = _mm_set1_epi32(mapa->linhas), colunas = _mm_set1_epi32(mapa->colunas);
+    int PX[8], PY[8];
 
-    //Percorre a lista efeitos nefasto enquanto o proxímo elemento não é nulo, ou seja, percorre até ao final da lista ligada
-    while (aux != NULL) {
-        printf("| (%2d,%2d) |\n", aux->x, aux->y);
-        aux = aux -> prox; //Avança para a próxima posição da lista
+    for (; j + 4 <= n; j += 4) {
+        __m128i bx = _mm_loadu_si128((const __m128i*)(xs + j));
+        __m128i by = _mm_loadu_si128((const __m128i*)(ys + j));
+
+        //Ponto 1) = 2A - B e ponto 2) = 2B - A, para 4 parceiras em simultâneo
+        __m128i p1x = _mm_sub_epi32(ax2, bx), p1y = _mm_sub_epi32(ay2, by);
+        __m128i p2x = _mm_sub_epi32(_mm_add_epi32(bx, bx), ax);
+        __m128i p2y = _mm_sub_epi32(_mm_add_epi32(by, by), ay);
+
+        //Máscara com todos os bits ligados nas posições com 0 <= x < linhas e 0 <= y < colunas
+        __m128i m1 = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(p1x, menosUm), _mm_cmpgt_epi32(linhas, p1x)),
+                                   _mm_and_si128(_mm_cmpgt_epi32(p1y, menosUm), _mm_cmpgt_epi32(colunas, p1y)));
+        __m128i m2 = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(p2x, menosUm), _mm_cmpgt_epi32(linhas, p2x)),
+                                   _mm_and_si128(_mm_cmpgt_epi32(p2y, menosUm), _mm_cmpgt_epi32(colunas, p2y)));
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(m1)) | (_mm_movemask_ps(_mm_castsi128_ps(m2)) << 4);
+
+        //Só os pontos dentro do mapa são copiados para a saída
+        if (bits != 0) {
+            _mm_storeu_si128((__m128i*)PX, p1x);
+            _mm_storeu_si128((__m128i*)(PX + 4), p2x);
+            _mm_storeu_si128((__m128i*)PY, p1y);
+            _mm_storeu_si128((__m128i*)(PY + 4), p2y);
+            while (bits != 0) {
+                int k = __builtin_ctz((unsigned)bits);
+                bits &= bits - 1;
+                rx[total] = PX[k];
+                ry[total] = PY[k];
+                total++;
+            }
+        }
     }
+#endif
 
-    return true;
+    //Versão escalar, usada para as parceiras que sobram (ou para todas, sem SIMD)
+    for (; j < n; j++) {
+        int x1 = 2 * xa - xs[j], y1 = 2 * ya - ys[j];
+        int x2 = 2 * xs[j] - xa, y2 = 2 * ys[j] - ya;
+
+        if (dentroDoMapa(mapa, x1, y1)) {
+            rx[total] = x1;
+            ry[total] = y1;
+            total++;
+        }
+        if (dentroDoMapa(mapa, x2, y2)) {
+            rx[total] = x2;
+            ry[total] = y2;
+            total++;
+        }
+    }
+    return total;
 }
 
+/// @brief Devolve o número de antenas do maior grupo de frequência
+/// @param f Apontador para os grupos
+/// @return Devolve o tamanho do maior grupo
+static int maiorGrupo(Frequencias* f) {
+    int maior = 0;
+    for (int k = 0; k < NUM_FREQ; k++) {
+        if (f->grupos[k].n > maior) {
+            maior = f->grupos[k].n;
+        }
+    }
+    return maior;
+}
 
-/// @brief Imprime o mapa original e adiciona as localizações com efeito nefasto (#)
-/// @param nomeFicheiro Nome do ficheiro que contém o mapa das antenas
-/// @param h Apontador para o início da lista de efeitos nefastos
-bool imprimirAntenasNefasto(char* nomeFicheiro, Nefasto* h) {
-    int linha = 0, coluna = 0;
-    char c;
+/// @brief Calcula as posições com efeito nefasto baseado na lista de antenas existentes
+/// @param mapa Apontador para o mapa com a lista de antenas e os limites
+/// @return Devolve uma lista ligada com todas as posições de efeitos nefastos encontradas
+Nefasto* efeitoNefasto (Mapa* mapa) {
+    Nefasto* lista = NULL;
+    Frequencias f;
+    GrupoFrequencia* g;
+    int *rx, *ry, total, maior;
 
-    FILE * fp = fopen(nomeFicheiro, "r"); //Abre o ficheiro em modo de leitura
+    if (mapa == NULL) {
+        return NULL;
+    }
+    INICIAR_TEMPO(tempoInicio);
 
-    if (fp == NULL) { // Verifica se o ficheiro abre
-        return false;
+    //Agrupa as antenas por frequência, para só comparar pares que podem interferir
+    if (!agruparFrequencias(mapa->antenas, &f)) {
+        return NULL;
     }
 
-    //Começa por ler o ficheiro caractere a caractere
-    while ((c = getc(fp)) != EOF && linha < MAXi) {
-        if (c == '\n') { //Se o caratere for a mudança de linha passa para a proxima linha, e volta a coluna ao zero, para começar do inicio da proxima linha
-            linha++;
-            coluna = 0;
-            printf("\n");
-        } else if (coluna < MAXj) { //Depois verifica se a posição tem o efeito nefasto
-            Nefasto* aux = h;
-            int nefasto = 0; //Inicializa como falso (não é nefasto)
-            while (aux != NULL) {
-                if (aux->x == linha && aux->y == coluna) {
-                    nefasto = 1; //É nefasto
-                    break; //A procura é interrompida
-                }
-                aux = aux->prox;
-            }
+    //Vetores para os pontos de uma antena contra as restantes do grupo (no máximo 2 por parceira)
+    maior = maiorGrupo(&f);
+    rx = (int*)malloc((size_t)(2 * maior + 1) * sizeof(int));
+    ry = (int*)malloc((size_t)(2 * maior + 1) * sizeof(int));
+    if (rx == NULL || ry == NULL) {
+        free(rx);
+        free(ry);
+        libertarFrequencias(&f);
+        return NULL;
+    }
 
-            //Se (nefasto == 1)
-            if (nefasto) {
-                printf("#");  //Substitui por '#' se for nefasto
-            } else if (c == '.' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
-                printf("%c", c);  //Imprime o caractere original
+    //Percorre cada grupo de frequência
+    for (int k = 0; k < NUM_FREQ; k++) {
+        g = &f.grupos[k];
+
+        //Compara cada antena do grupo com as seguintes (todas têm a mesma frequência)
+        for (int i = 0; i < g->n; i++) {
+            total = calcularAntinodos(g->x[i], g->y[i], g->x + i + 1, g->y + i + 1, g->n - i - 1, mapa, rx, ry);
+
+            //Adiciona à lista ligada os pontos que estão dentro dos limites do mapa
+            for (int j = 0; j < total; j++) {
+                lista = inserirNefasto(lista, criarNefastoMapa(mapa, rx[j], ry[j]));
             }
-            coluna++;
         }
     }
-    fclose(fp); //Fecha o ficheiro
-    return true;
-}
\ No newline at end of file
+
+    free(rx);
+    free(ry);
+    libertarFrequencias(&f);
+    TERMINAR_TEMPO(tempoInicio, FASE_NEFASTO);
+    return lista;   //Devolve a lista de efeitos nefastos
+}
+
+/// @brief Cria uma grelha de bits com um bit por cada posição do mapa
+/// @param linhas Número de linhas do mapa
+/// @param colunas Número de colunas do mapa
+/// @return Devolve a nova grelha com todas as posições desmarcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* criarGrelhaBits(int linhas, int colunas) {
+    GrelhaBits* g;
+    size_t palavras;
+
+    if (linhas < 0 || colunas < 0) {
+        return NULL;
+    }
+
+    g = (GrelhaBits*)malloc(sizeof(GrelhaBits));
+    if (g == NULL) {
+        return NULL;
+    }
+
+    //Cada palavra de 64 bits guarda 64 posições consecutivas (linha a linha)
+    palavras = ((size_t)linhas * (size_t)colunas + 63) / 64;
+    g->bits = (uint64_t*)calloc(palavras > 0 ? palavras : 1, sizeof(uint64_t));
+    if (g->bits == NULL) {
+        free(g);
+        return NULL;
+    }
+
+    g->linhas = linhas;
+    g->colunas = colunas;
+    g->contagem = 0;
+    return g;
+}
+
+/// @brief Marca uma posição da grelha, sem contar a mesma posição duas vezes
+/// @param g Apontador para a grelha
+/// @param x Coordenada x da posição
+/// @param y Coordenada y da posição
+/// @return Devolve true se a posição ainda não estava marcada
+bool marcarGrelhaBits(GrelhaBits* g, int x, int y) {
+    size_t i = (size_t)x * (size_t)g->colunas + (size_t)y;
+    uint64_t mascara = (uint64_t)1 << (i & 63);
+
+    //Se o bit já estiver ligado, a posição já foi contada
+    if (g->bits[i >> 6] & mascara) {
+        return false;
+    }
+    g->bits[i >> 6] |= mascara;
+    g->contagem++;
+    return true;
+}
+
+/// @brief Verifica se uma posição da grelha está marcada
+/// @param g Apontador para a grelha
+/// @param x Coordenada x da posição
+/// @param y Coordenada y da posição
+/// @return Devolve true se a posição estiver marcada
+bool testarGrelhaBits(GrelhaBits* g, int x, int y) {
+    size_t i = (size_t)x * (size_t)g->colunas + (size_t)y;
+    return (g->bits[i >> 6] >> (i & 63)) & 1;
+}
+
+/// @brief Devolve o número de posições diferentes marcadas na grelha
+/// @param g Apontador para a grelha
+/// @return Devolve o número de posições marcadas (0 se a grelha não existir)
+long contarGrelhaBits(GrelhaBits* g) {
+    if (g == NULL) {
+        return 0;
+    }
+    return g->contagem;
+}
+
+/// @brief Converte uma grelha de bits numa lista ligada de efeitos nefastos ordenada por (x,y)
+/// @param mapa Apontador para o mapa cuja memória é usada para a lista (NULL para usar malloc)
+/// @param g Apontador para a grelha
+/// @return Devolve a lista de efeitos nefastos, sem repetições, com as posições marcadas na grelha
+Nefasto* grelhaParaNefasto(Mapa* mapa, GrelhaBits* g) {
+    Nefasto* lista = NULL;
+    Nefasto* ultimo = NULL;
+    Nefasto* novo;
+    size_t palavras, i;
+    uint64_t palavra;
+    int bit;
+
+    if (g == NULL) {
+        return NULL;
+    }
+
+    palavras = ((size_t)g->linhas * (size_t)g->colunas + 63) / 64;
+
+    //Percorre a grelha palavra a palavra; as palavras vazias são saltadas de uma só vez
+    for (i = 0; i < palavras; i++) {
+        palavra = g->bits[i];
+        while (palavra != 0) {
+            bit = __builtin_ctzll(palavra);     //Índice do bit ligado mais baixo
+            palavra &= palavra - 1;             //Desliga esse bit
+
+            size_t posicao = i * 64 + (size_t)bit;
+            if (mapa != NULL) {
+                novo = criarNefastoMapa(mapa, (int)(posicao / (size_t)g->colunas), (int)(posicao % (size_t)g->colunas));
+            } else {
+                novo = criarNefasto((int)(posicao / (size_t)g->colunas), (int)(posicao % (size_t)g->colunas));
+            }
+            if (novo == NULL) {
+                return lista;
+            }
+
+            //As posições saem por ordem, por isso basta acrescentar no fim da lista
+            if (ultimo == NULL) {
+                lista = novo;
+            } else {
+                ultimo->prox = novo;
+            }
+            ultimo = novo;
+        }
+    }
+    return lista;
+}
+
+/// @brief Liberta a memória ocupada por uma grelha de bits
+/// @param g Apontador para a grelha a libertar
+void libertarGrelhaBits(GrelhaBits* g) {
+    if (g != NULL) {
+        free(g->bits);
+        free(g);
+    }
+}
+
+/// @brief Calcula as posições com efeito nefasto e marca-as numa grelha de bits em vez de uma lista ligada
+/// @param mapa Apontador para o mapa com a lista de antenas e as dimensões da grelha
+/// @return Devolve uma grelha com as posições de efeito nefasto marcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* efeitoNefastoGrelha(Mapa* mapa) {
+    GrelhaBits* grelha;
+    Frequencias f;
+    GrupoFrequencia* g;
+    int *rx, *ry, total, maior;
+
+    if (mapa == NULL) {
+        return NULL;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    grelha = criarGrelhaBits(mapa->linhas, mapa->colunas);
+    if (grelha == NULL) {
+        return NULL;
+    }
+
+    if (!agruparFrequencias(mapa->antenas, &f)) {
+        libertarGrelhaBits(grelha);
+        return NULL;
+    }
+
+    maior = maiorGrupo(&f);
+    rx = (int*)malloc((size_t)(2 * maior + 1) * sizeof(int));
+    ry = (int*)malloc((size_t)(2 * maior + 1) * sizeof(int));
+    if (rx == NULL || ry == NULL) {
+        free(rx);
+        free(ry);
+        libertarFrequencias(&f);
+        libertarGrelhaBits(grelha);
+        return NULL;
+    }
+
+    //Mesmo cálculo de efeitoNefasto, mas cada ponto é marcado na grelha em O(1)
+    for (int k = 0; k < NUM_FREQ; k++) {
+        g = &f.grupos[k];
+        for (int i = 0; i < g->n; i++) {
+            total = calcularAntinodos(g->x[i], g->y[i], g->x + i + 1, g->y + i + 1, g->n - i - 1, mapa, rx, ry);
+            for (int j = 0; j < total; j++) {
+                marcarGrelhaBits(grelha, rx[j], ry[j]);
+            }
+        }
+    }
+
+    free(rx);
+    free(ry);
+    libertarFrequencias(&f);
+    TERMINAR_TEMPO(tempoInicio, FASE_NEFASTO);
+    return grelha;
+}
+
+/// @brief Tarefa de cálculo paralelo: um intervalo de antenas de um grupo de frequência
+typedef struct TarefaPares {
+    int grupo;                  //Índice do grupo de frequência
+    int inicio, fim;            //Antenas [inicio, fim) do grupo, comparadas com as seguintes
+} TarefaPares;
+
+/// @brief Trabalho partilhado pelas threads de um cálculo paralelo
+typedef struct TrabalhoParalelo {
+    Mapa* mapa;                 //Mapa com os limites
+    Frequencias* f;             //Grupos de antenas por frequência
+    TarefaPares* tarefas;       //Lista de tarefas a distribuir
+    int numTarefas;             //Número de tarefas
+    atomic_int proxima;         //Índice da próxima tarefa por atribuir
+    int numThreads;             //Número de threads
+    GrelhaBits** grelhas;       //Grelha privada de cada thread
+    GrelhaBits* resultado;      //Grelha final
+    atomic_bool erro;           //Indica se alguma thread não conseguiu alocar espaço (escrito por várias threads)
+    void (*executar)(struct TrabalhoParalelo* t, TarefaPares* tarefa, GrelhaBits* g, int* rx, int* ry);
+    EstadoNefasto* estado;                  //Estado consultado (só em avaliarCandidatos)
+    const CandidatoAntena* candidatos;      //Candidatas a avaliar (só em avaliarCandidatos)
+    int numCandidatos;                      //Número de candidatas
+    long* resultados;                       //Resultado de cada candidata
+} TrabalhoParalelo;
+
+/// @brief Argumento de cada thread
+typedef struct ArgumentoThread {
+    TrabalhoParalelo* t;
+    int indice;                 //Número da thread (0 até numThreads-1)
+} ArgumentoThread;
+
+/// @brief Devolve o número de processadores disponíveis
+/// @return Devolve o número de processadores (pelo menos 1)
+static int processadoresDisponiveis(void) {
+#ifdef _WIN32
+    return 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+#endif
+}
+
+/// @brief Divide os pares de cada grupo de frequência em tarefas com um número de pares semelhante
+/// @param f Apontador para os grupos
+/// @param numTarefas Apontador onde é devolvido o número de tarefas (-1 se não conseguir alocar espaço)
+/// @return Devolve o vetor de tarefas (NULL se não houver tarefas)
+static TarefaPares* dividirTarefas(Frequencias* f, int* numTarefas) {
+    TarefaPares* tarefas = NULL;
+    int capacidade = 0, n = 0;
+
+    *numTarefas = -1;
+
+    for (int k = 0; k < NUM_FREQ; k++) {
+        GrupoFrequencia* g = &f->grupos[k];
+        int inicio = 0;
+        long pares = 0;
+
+        //A antena i forma n-1-i pares com as seguintes; fecha-se uma tarefa quando o total chega ao limite
+        for (int i = 0; i < g->n; i++) {
+            pares += g->n - 1 - i;
+            if (pares >= PARES_POR_TAREFA || i == g->n - 1) {
+                if (n == capacidade) {
+                    capacidade = (capacidade == 0) ? 64 : capacidade * 2;
+                    TarefaPares* novo = (TarefaPares*)realloc(tarefas, (size_t)capacidade * sizeof(TarefaPares));
+                    if (novo == NULL) {
+                        free(tarefas);
+                        return NULL;
+                    }
+                    tarefas = novo;
+                }
+                tarefas[n].grupo = k;
+                tarefas[n].inicio = inicio;
+                tarefas[n].fim = i + 1;
+                n++;
+                inicio = i + 1;
+                pares = 0;
+            }
+        }
+    }
+
+    *numTarefas = n;
+    return tarefas;
+}
+
+/// @brief Executa uma tarefa de efeitoNefastoParalelo: pares (i, j>i) das antenas [inicio, fim) do grupo
+static void executarTarefaPares(TrabalhoParalelo* t, TarefaPares* tarefa, GrelhaBits* grelha, int* rx, int* ry) {
+    GrupoFrequencia* g = &t->f->grupos[tarefa->grupo];
+
+    for (int i = tarefa->inicio; i < tarefa->fim; i++) {
+        int total = calcularAntinodos(g->x[i], g->y[i], g->x + i + 1, g->y + i + 1, g->n - i - 1, t->mapa, rx, ry);
+        for (int j = 0; j < total; j++) {
+            marcarGrelhaBits(grelha, rx[j], ry[j]);
+        }
+    }
+}
+
+/// @brief Ciclo de cada thread: vai buscando tarefas até não haver mais, escrevendo só na sua grelha
+static void* trabalhadorTarefas(void* arg) {
+    ArgumentoThread* a = (ArgumentoThread*)arg;
+    TrabalhoParalelo* t = a->t;
+    GrelhaBits* grelha = t->grelhas[a->indice];
+    int maior = maiorGrupo(t->f);
+    int* rx = (int*)malloc((size_t)(2 * maior + 1) * sizeof(int));
+    int* ry = (int*)malloc((size_t)(2 * maior + 1) * sizeof(int));
+    int i;
+
+    if (rx == NULL || ry == NULL) {
+        atomic_store(&t->erro, true);
+    } else {
+        //Cada thread pede a próxima tarefa livre, por isso as threads mais rápidas fazem mais tarefas
+        while ((i = atomic_fetch_add(&t->proxima, 1)) < t->numTarefas) {
+            t->executar(t, &t->tarefas[i], grelha, rx, ry);
+        }
+    }
+
+    free(rx);
+    free(ry);
+    return NULL;
+}
+
+/// @brief Junta (OR) as grelhas privadas na grelha final, para a fatia de palavras atribuída à thread
+static void* trabalhadorReducao(void* arg) {
+    ArgumentoThread* a = (ArgumentoThread*)arg;
+    TrabalhoParalelo* t = a->t;
+    size_t palavras = ((size_t)t->resultado->linhas * (size_t)t->resultado->colunas + 63) / 64;
+    size_t inicio = palavras * (size_t)a->indice / (size_t)t->numThreads;
+    size_t fim = palavras * (size_t)(a->indice + 1) / (size_t)t->numThreads;
+
+    for (size_t w = inicio; w < fim; w++) {
+        uint64_t v = 0;
+        for (int k = 0; k < t->numThreads; k++) {
+            v |= t->grelhas[k]->bits[w];
+        }
+        t->resultado->bits[w] = v;
+    }
+    return NULL;
+}
+
+/// @brief Corre uma função em numThreads threads (a última na thread atual) e espera que terminem
+static void correrThreads(TrabalhoParalelo* t, void* (*funcao)(void*)) {
+    pthread_t* threads = (pthread_t*)malloc((size_t)t->numThreads * sizeof(pthread_t));
+    ArgumentoThread* args = (ArgumentoThread*)malloc((size_t)t->numThreads * sizeof(ArgumentoThread));
+    int criadas = 0;
+
+    if (threads == NULL || args == NULL) {
+        //Sem espaço para as threads, a thread atual faz o trabalho de todas
+        for (int k = 0; k < t->numThreads; k++) {
+            ArgumentoThread a = { t, k };
+            funcao(&a);
+        }
+        free(threads);
+        free(args);
+        return;
+    }
+
+    for (int k = 0; k < t->numThreads; k++) {
+        args[k].t = t;
+        args[k].indice = k;
+    }
+    for (int k = 0; k < t->numThreads - 1; k++) {
+        if (pthread_create(&threads[k], NULL, funcao, &args[k]) != 0) {
+            break;
+        }
+        criadas++;
+    }
+    //As threads que não foi possível criar são executadas aqui
+    for (int k = criadas; k < t->numThreads; k++) {
+        funcao(&args[k]);
+    }
+    for (int k = 0; k < criadas; k++) {
+        pthread_join(threads[k], NULL);
+    }
+
+    free(threads);
+    free(args);
+}
+
+/// @brief Distribui as tarefas por várias threads, cada uma com a sua grelha privada, e junta as grelhas no fim
+/// @param t Trabalho já preenchido com o mapa, os grupos, as tarefas e a função executar
+/// @param numThreads Número de threads pedido (0 ou negativo para usar todos os processadores)
+/// @return Devolve a grelha final ou NULL se não conseguir alocar espaço
+static GrelhaBits* executarEmParalelo(TrabalhoParalelo* t, int numThreads) {
+    GrelhaBits* resultado;
+    size_t palavras;
+    long contagem = 0;
+
+    if (numThreads <= 0) {
+        numThreads = processadoresDisponiveis();
+    }
+    //Não vale a pena ter mais threads do que tarefas
+    if (numThreads > t->numTarefas) {
+        numThreads = (t->numTarefas > 0) ? t->numTarefas : 1;
+    }
+
+    t->numThreads = numThreads;
+    atomic_init(&t->proxima, 0);
+    atomic_init(&t->erro, false);
+
+    resultado = criarGrelhaBits(t->mapa->linhas, t->mapa->colunas);
+    if (resultado == NULL) {
+        return NULL;
+    }
+    t->resultado = resultado;
+
+    //Com uma só thread não é preciso grelha privada nem redução
+    if (numThreads == 1) {
+        t->grelhas = &t->resultado;
+        ArgumentoThread a = { t, 0 };
+        trabalhadorTarefas(&a);
+        if (atomic_load(&t->erro)) {
+            libertarGrelhaBits(resultado);
+            return NULL;
+        }
+        return resultado;
+    }
+
+    t->grelhas = (GrelhaBits**)calloc((size_t)numThreads, sizeof(GrelhaBits*));
+    if (t->grelhas == NULL) {
+        libertarGrelhaBits(resultado);
+        return NULL;
+    }
+    for (int k = 0; k < numThreads; k++) {
+        t->grelhas[k] = criarGrelhaBits(t->mapa->linhas, t->mapa->colunas);
+        if (t->grelhas[k] == NULL) {
+            atomic_store(&t->erro, true);
+        }
+    }
+
+    if (!atomic_load(&t->erro)) {
+        //1) Cada thread marca os pontos das suas tarefas na sua grelha, sem sincronização
+        correrThreads(t, trabalhadorTarefas);
+    }
+    if (!atomic_load(&t->erro)) {
+        //2) A grelha final é o OR das grelhas privadas, com as palavras divididas pelas threads
+        correrThreads(t, trabalhadorReducao);
+    }
+
+    for (int k = 0; k < numThreads; k++) {
+        libertarGrelhaBits(t->grelhas[k]);
+    }
+    free(t->grelhas);
+
+    if (atomic_load(&t->erro)) {
+        libertarGrelhaBits(resultado);
+        return NULL;
+    }
+
+    //A contagem das grelhas privadas não serve (há repetições entre threads), por isso é recalculada
+    palavras = ((size_t)resultado->linhas * (size_t)resultado->colunas + 63) / 64;
+    for (size_t w = 0; w < palavras; w++) {
+        contagem += __builtin_popcountll(resultado->bits[w]);
+    }
+    resultado->contagem = contagem;
+    return resultado;
+}
+
+/// @brief Calcula as posições com efeito nefasto usando várias threads, cada uma com a sua grelha de bits
+/// @param mapa Apontador para o mapa com a lista de antenas e as dimensões da grelha
+/// @param numThreads Número de threads (0 ou negativo para usar todos os processadores)
+/// @return Devolve uma grelha com as posições de efeito nefasto marcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* efeitoNefastoParalelo(Mapa* mapa, int numThreads) {
+    TrabalhoParalelo t;
+    Frequencias f;
+    GrelhaBits* resultado;
+
+    if (mapa == NULL) {
+        return NULL;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    if (!agruparFrequencias(mapa->antenas, &f)) {
+        return NULL;
+    }
+
+    t.mapa = mapa;
+    t.f = &f;
+    t.executar = executarTarefaPares;
+    t.tarefas = dividirTarefas(&f, &t.numTarefas);
+    if (t.numTarefas < 0) {
+        libertarFrequencias(&f);
+        return NULL;
+    }
+
+    resultado = executarEmParalelo(&t, numThreads);
+
+    free(t.tarefas);
+    libertarFrequencias(&f);
+    if (resultado != NULL) {
+        TERMINAR_TEMPO(tempoInicio, FASE_NEFASTO);
+    }
+    return resultado;
+}
+
+/*
+* Modo de harmónicos: todas as posições da grelha na reta que passa por duas antenas com a mesma
+* frequência têm efeito nefasto (incluindo as próprias antenas).
+*
+* Para o par A1 = (x1,y1) e A2 = (x2,y2), o passo da reta é (dx,dy) / mdc(|dx|,|dy|), o menor vetor
+* com coordenadas inteiras nessa direção, e as posições são A1 + t*passo. Os valores de t que ficam
+* dentro do mapa são calculados no início, eixo a eixo, por isso o ciclo que marca as posições não
+* precisa de verificar os limites. Na grelha (guardada linha a linha) cada passo avança sempre o mesmo
+* número de bits: px*colunas + py.
+*/
+
+/// @brief Calcula o máximo divisor comum de dois números não negativos
+/// @param a Primeiro número
+/// @param b Segundo número
+/// @return Devolve o máximo divisor comum (0 se ambos forem 0)
+static int maximoDivisorComum(int a, int b) {
+    while (b != 0) {
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/// @brief Divisão inteira arredondada para baixo (o divisor tem de ser positivo)
+/// @param a Dividendo
+/// @param b Divisor
+/// @return Devolve o maior inteiro menor ou igual a a/b
+static long long divisaoAbaixo(long long a, long long b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/// @brief Restringe o intervalo [tmin, tmax] aos valores de t com 0 <= inicio + t*passo < limite
+/// @param inicio Coordenada da antena de partida (pode estar fora do mapa)
+/// @param passo Passo nesse eixo
+/// @param limite Número de linhas ou de colunas do mapa
+/// @param tmin Apontador para o menor t válido
+/// @param tmax Apontador para o maior t válido (fica menor que tmin se nenhum t for válido)
+static void limitarPassos(int inicio, int passo, int limite, long long* tmin, long long* tmax) {
+    long long baixo, alto;
+
+    //Com passo 0 a coordenada não muda: ou todos os t servem, ou nenhum
+    if (passo == 0) {
+        if (inicio < 0 || inicio >= limite) {
+            *tmin = 1;
+            *tmax = 0;
+        }
+        return;
+    }
+    //A antena pode estar fora do mapa, por isso os limites usam divisões arredondadas para baixo e para cima
+    if (passo > 0) {
+        baixo = -divisaoAbaixo(inicio, passo);                            //ceil(-inicio / passo)
+        alto = divisaoAbaixo((long long)limite - 1 - inicio, passo);
+    } else {
+        baixo = -divisaoAbaixo((long long)limite - 1 - inicio, -(long long)passo);
+        alto = divisaoAbaixo(inicio, -(long long)passo);
+    }
+    if (baixo > *tmin) {
+        *tmin = baixo;
+    }
+    if (alto < *tmax) {
+        *tmax = alto;
+    }
+}
+
+/// @brief Marca na grelha todas as posições da reta que passa por duas antenas
+/// @param grelha Apontador para a grelha
+/// @param x1 Coordenada x da primeira antena
+/// @param y1 Coordenada y da primeira antena
+/// @param x2 Coordenada x da segunda antena
+/// @param y2 Coordenada y da segunda antena
+static void marcarReta(GrelhaBits* grelha, int x1, int y1, int x2, int y2) {
+    int dx = x2 - x1, dy = y2 - y1;
+    int d = maximoDivisorComum(abs(dx), abs(dy));
+    long long tmin = LLONG_MIN, tmax = LLONG_MAX;
+    long contagem = 0;
+    ptrdiff_t i, avanco;
+
+    //Duas antenas na mesma posição não definem uma reta
+    if (d == 0) {
+        return;
+    }
+    dx /= d;
+    dy /= d;
+    limitarPassos(x1, dx, grelha->linhas, &tmin, &tmax);
+    limitarPassos(y1, dy, grelha->colunas, &tmin, &tmax);
+    if (tmin > tmax) {
+        return;         //A reta não passa pelo mapa
+    }
+
+    avanco = (ptrdiff_t)dx * grelha->colunas + dy;
+    i = ((ptrdiff_t)x1 + (ptrdiff_t)tmin * dx) * grelha->colunas + y1 + (ptrdiff_t)tmin * dy;
+    for (long long t = tmin; t <= tmax; t++, i += avanco) {
+        uint64_t mascara = (uint64_t)1 << (i & 63);
+        contagem += !(grelha->bits[i >> 6] & mascara);
+        grelha->bits[i >> 6] |= mascara;
+    }
+    grelha->contagem += contagem;
+}
+
+/// @brief Executa uma tarefa de efeitoNefastoHarmonicos: retas dos pares (i, j>i) das antenas [inicio, fim) do grupo
+static void executarTarefaHarmonicos(TrabalhoParalelo* t, TarefaPares* tarefa, GrelhaBits* grelha, int* rx, int* ry) {
+    GrupoFrequencia* g = &t->f->grupos[tarefa->grupo];
+
+    (void)rx;
+    (void)ry;
+    for (int i = tarefa->inicio; i < tarefa->fim; i++) {
+        CONTAR(paresComparados, g->n - i - 1);
+        for (int j = i + 1; j < g->n; j++) {
+            marcarReta(grelha, g->x[i], g->y[i], g->x[j], g->y[j]);
+        }
+    }
+}
+
+/// @brief Calcula as posições com efeito nefasto no modo de harmónicos (todas as posições alinhadas com duas antenas da mesma frequência)
+/// @param mapa Apontador para o mapa com a lista de antenas e as dimensões da grelha
+/// @param numThreads Número de threads (0 ou negativo para usar todos os processadores, 1 para não criar threads)
+/// @return Devolve uma grelha com as posições de efeito nefasto marcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* efeitoNefastoHarmonicos(Mapa* mapa, int numThreads) {
+    TrabalhoParalelo t;
+    Frequencias f;
+    GrelhaBits* resultado;
+
+    if (mapa == NULL) {
+        return NULL;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    if (!agruparFrequencias(mapa->antenas, &f)) {
+        return NULL;
+    }
+
+    //As tarefas e as threads são as mesmas de efeitoNefastoParalelo, só muda o trabalho feito por cada par
+    t.mapa = mapa;
+    t.f = &f;
+    t.executar = executarTarefaHarmonicos;
+    t.tarefas = dividirTarefas(&f, &t.numTarefas);
+    if (t.numTarefas < 0) {
+        libertarFrequencias(&f);
+        return NULL;
+    }
+
+    resultado = executarEmParalelo(&t, numThreads);
+
+    free(t.tarefas);
+    libertarFrequencias(&f);
+    if (resultado != NULL) {
+        TERMINAR_TEMPO(tempoInicio, FASE_NEFASTO);
+    }
+    return resultado;
+}
+
+/// @brief Garante que os vetores auxiliares do estado têm espaço para os pontos de n parceiras
+/// @param e Apontador para o estado
+/// @param n Número de parceiras
+/// @return Devolve false se não conseguir alocar espaço
+static bool reservarPontosEstado(EstadoNefasto* e, int n) {
+    if (2 * n + 1 <= e->capacidade) {
+        return true;
+    }
+
+    int capacidade = 2 * n + 1;
+    int* rx = (int*)realloc(e->rx, (size_t)capacidade * sizeof(int));
+    if (rx == NULL) {
+        return false;
+    }
+    e->rx = rx;
+    int* ry = (int*)realloc(e->ry, (size_t)capacidade * sizeof(int));
+    if (ry == NULL) {
+        return false;
+    }
+    e->ry = ry;
+    e->capacidade = capacidade;
+    return true;
+}
+
+/// @brief Soma (ou subtrai) a contribuição dos pares entre uma antena e as n primeiras antenas de um grupo
+/// @param e Apontador para o estado
+/// @param g Grupo com as antenas parceiras
+/// @param n Número de antenas parceiras (as primeiras n do grupo)
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @param sinal +1 para acrescentar os pares, -1 para os retirar
+/// @return Devolve false se não conseguir alocar espaço
+static bool atualizarParesEstado(EstadoNefasto* e, GrupoFrequencia* g, int n, int x, int y, int sinal) {
+    int total, i;
+    size_t pos;
+
+    if (!reservarPontosEstado(e, n)) {
+        return false;
+    }
+
+    total = calcularAntinodos(x, y, g->x, g->y, n, e->mapa, e->rx, e->ry);
+    for (i = 0; i < total; i++) {
+        pos = (size_t)e->rx[i] * (size_t)e->mapa->colunas + (size_t)e->ry[i];
+        if (sinal > 0) {
+            //A posição passa a ter efeito nefasto quando recebe o primeiro par
+            if (e->contagem[pos]++ == 0) {
+                e->unicos++;
+            }
+        } else {
+            //A posição deixa de ter efeito nefasto quando perde o último par
+            if (--e->contagem[pos] == 0) {
+                e->unicos--;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Cria o estado incremental de um mapa, com a contagem de pares por posição das antenas atuais
+/// @param mapa Apontador para o mapa a acompanhar
+/// @return Devolve o novo estado ou NULL se não conseguir alocar espaço
+EstadoNefasto* criarEstadoNefasto(Mapa* mapa) {
+    EstadoNefasto* e;
+    GrupoFrequencia* g;
+    size_t celulas;
+
+    if (mapa == NULL) {
+        return NULL;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    e = (EstadoNefasto*)malloc(sizeof(EstadoNefasto));
+    if (e == NULL) {
+        return NULL;
+    }
+
+    e->mapa = mapa;
+    e->unicos = 0;
+    e->antenaEm = NULL;
+    e->rx = NULL;
+    e->ry = NULL;
+    e->capacidade = 0;
+
+    celulas = (size_t)mapa->linhas * (size_t)mapa->colunas;
+    e->contagem = (unsigned int*)calloc(celulas > 0 ? celulas : 1, sizeof(unsigned int));
+    e->antenaEm = (Antena**)calloc(celulas > 0 ? celulas : 1, sizeof(Antena*));
+    if (e->contagem == NULL || e->antenaEm == NULL) {
+        free(e->contagem);
+        free(e->antenaEm);
+        free(e);
+        return NULL;
+    }
+
+    if (!agruparFrequencias(mapa->antenas, &e->grupos)) {
+        free(e->contagem);
+        free(e->antenaEm);
+        free(e);
+        return NULL;
+    }
+
+    //Índice das posições ocupadas, para inserir e remover sem percorrer a lista do mapa
+    for (Antena* aux = mapa->antenas; aux != NULL; aux = aux->prox) {
+        if (dentroDoMapa(mapa, aux->x, aux->y)) {
+            e->antenaEm[(size_t)aux->x * (size_t)mapa->colunas + (size_t)aux->y] = aux;
+        }
+    }
+
+    //Conta cada par (i, j>i) uma vez, como em efeitoNefastoGrelha
+    for (int k = 0; k < NUM_FREQ; k++) {
+        g = &e->grupos.grupos[k];
+        for (int i = 1; i < g->n; i++) {
+            if (!atualizarParesEstado(e, g, i, g->x[i], g->y[i], +1)) {
+                libertarEstadoNefasto(e);
+                return NULL;
+            }
+        }
+    }
+    TERMINAR_TEMPO(tempoInicio, FASE_ESTADO);
+    return e;
+}
+
+/// @brief Insere uma antena no mapa e atualiza só os pares com as antenas da mesma frequência
+/// @param e Apontador para o estado
+/// @param freq Frequência da nova antena
+/// @param x Coordenada x da nova antena
+/// @param y Coordenada y da nova antena
+/// @return Devolve false se a frequência não for válida, se a posição estiver fora do mapa ou ocupada, ou se não conseguir alocar espaço
+bool inserirAntenaEstado(EstadoNefasto* e, char freq, int x, int y) {
+    int k = indiceFrequencia(freq);
+    GrupoFrequencia* g;
+    Antena* nova;
+    size_t pos;
+
+    if (e == NULL || k < 0 || !dentroDoMapa(e->mapa, x, y)) {
+        return false;
+    }
+    pos = (size_t)x * (size_t)e->mapa->colunas + (size_t)y;
+    if (e->antenaEm[pos] != NULL) {
+        return false;
+    }
+    g = &e->grupos.grupos[k];
+
+    //Os novos pares são os da nova antena com cada antena já existente no grupo
+    if (!atualizarParesEstado(e, g, g->n, x, y, +1)) {
+        return false;
+    }
+
+    nova = criarAntenaMapa(e->mapa, freq, x, y);
+    if (nova == NULL || !adicionarAoGrupo(g, x, y)) {
+        atualizarParesEstado(e, g, g->n, x, y, -1);
+        devolverPool(&e->mapa->poolAntenas, nova);
+        return false;
+    }
+
+    //A lista do mapa não está ordenada (carregarMapa insere no início), por isso a nova antena também fica no início
+    nova->prox = e->mapa->antenas;
+    e->mapa->antenas = nova;
+    e->antenaEm[pos] = nova;
+    return true;
+}
+
+/// @brief Remove uma antena do mapa e retira só os pares com as antenas da mesma frequência
+/// @param e Apontador para o estado
+/// @param x Coordenada x da antena a remover
+/// @param y Coordenada y da antena a remover
+/// @return Devolve false se a antena não existir
+bool removerAntenaEstado(EstadoNefasto* e, int x, int y) {
+    Antena* aux;
+    Antena* cabeca;
+    GrupoFrequencia* g;
+    size_t pos;
+    int k, i;
+
+    if (e == NULL || !dentroDoMapa(e->mapa, x, y)) {
+        return false;
+    }
+
+    //O índice de posições dá a antena (e a sua frequência) em O(1)
+    pos = (size_t)x * (size_t)e->mapa->colunas + (size_t)y;
+    aux = e->antenaEm[pos];
+    if (aux == NULL) {
+        return false;
+    }
+
+    k = indiceFrequencia(aux->freq);
+    if (k >= 0) {
+        g = &e->grupos.grupos[k];
+
+        //Reserva o espaço antes de alterar o grupo, para não deixar o estado a meio
+        if (!reservarPontosEstado(e, g->n)) {
+            return false;
+        }
+
+        //Tira a antena do grupo, trocando-a com a última
+        for (i = 0; i < g->n && (g->x[i] != x || g->y[i] != y); i++);
+        if (i < g->n) {
+            g->n--;
+            g->x[i] = g->x[g->n];
+            g->y[i] = g->y[g->n];
+
+            //Os pares a retirar são os da antena removida com as que ficaram no grupo
+            atualizarParesEstado(e, g, g->n, x, y, -1);
+        }
+    }
+
+    //Sem a antena anterior, a lista não pode ser religada em O(1): o nó removido recebe os dados do primeiro
+    //nó da lista, e é o primeiro nó que sai da lista e volta à memória do mapa
+    cabeca = e->mapa->antenas;
+    if (aux != cabeca) {
+        aux->freq = cabeca->freq;
+        aux->x = cabeca->x;
+        aux->y = cabeca->y;
+        if (dentroDoMapa(e->mapa, cabeca->x, cabeca->y)) {
+            e->antenaEm[(size_t)cabeca->x * (size_t)e->mapa->colunas + (size_t)cabeca->y] = aux;
+        }
+    }
+    e->mapa->antenas = cabeca->prox;
+    e->antenaEm[pos] = NULL;
+    devolverPool(&e->mapa->poolAntenas, cabeca);
+    return true;
+}
+
+/// @brief Devolve o número de posições diferentes com efeito nefasto, em O(1)
+/// @param e Apontador para o estado
+/// @return Devolve o número de posições com efeito nefasto (0 se o estado não existir)
+long contarNefastosEstado(EstadoNefasto* e) {
+    if (e == NULL) {
+        return 0;
+    }
+    return e->unicos;
+}
+
+/// @brief Verifica, em O(1), se uma posição tem efeito nefasto
+/// @param e Apontador para o estado
+/// @param x Coordenada x da posição
+/// @param y Coordenada y da posição
+/// @return Devolve true se a posição estiver dentro do mapa e tiver efeito nefasto
+bool nefastoEstado(EstadoNefasto* e, int x, int y) {
+    if (e == NULL || !dentroDoMapa(e->mapa, x, y)) {
+        return false;
+    }
+    return e->contagem[(size_t)x * (size_t)e->mapa->colunas + (size_t)y] > 0;
+}
+
+/*
+* Avaliação de candidatas: colocar a antena F em (x,y) só acrescenta os pares de (x,y) com as antenas
+* do grupo de F, por isso o número de novas posições com efeito nefasto é o número de pontos diferentes
+* desses pares cuja contagem no estado ainda é zero. O estado só é lido, e cada thread guarda os pontos
+* já vistos da candidata atual numa pequena tabela de dispersão própria, limpa no fim de cada candidata.
+* Cada candidata custa O(tamanho do grupo da sua frequência).
+*/
+
+/// @brief Espaço de trabalho de uma thread de avaliarCandidatos
+typedef struct TrabalhoCandidata {
+    int* rx;                    //Pontos calculados para a candidata atual
+    int* ry;
+    size_t* tabela;             //Tabela de dispersão com as posições já contadas (posição + 1, 0 = livre)
+    size_t* ocupadas;           //Entradas da tabela usadas pela candidata atual
+    size_t mascara;             //Tamanho da tabela menos 1 (o tamanho é uma potência de 2)
+} TrabalhoCandidata;
+
+/// @brief Conta as novas posições com efeito nefasto que uma candidata criaria
+/// @param e Apontador para o estado
+/// @param c Candidata
+/// @param w Espaço de trabalho da thread
+/// @return Devolve o número de novas posições (-1 se a frequência não for válida ou se a posição estiver fora do mapa ou ocupada)
+static long avaliarCandidata(EstadoNefasto* e, const CandidatoAntena* c, TrabalhoCandidata* w) {
+    int k = indiceFrequencia(c->freq);
+    GrupoFrequencia* g;
+    long novas = 0;
+    int total, usadas = 0;
+
+    //Uma antena já existente na posição formaria um par consigo própria (e inserirAntenaEstado também a recusa)
+    if (k < 0 || !dentroDoMapa(e->mapa, c->x, c->y) ||
+        e->antenaEm[(size_t)c->x * (size_t)e->mapa->colunas + (size_t)c->y] != NULL) {
+        return -1;
+    }
+    g = &e->grupos.grupos[k];
+
+    total = calcularAntinodos(c->x, c->y, g->x, g->y, g->n, e->mapa, w->rx, w->ry);
+    for (int i = 0; i < total; i++) {
+        size_t pos = (size_t)w->rx[i] * (size_t)e->mapa->colunas + (size_t)w->ry[i];
+        size_t h;
+
+        if (e->contagem[pos] != 0) {
+            continue;
+        }
+        //Sondagem linear: a posição só conta se ainda não estiver na tabela
+        for (h = (pos * 0x9E3779B97F4A7C15ULL) & w->mascara; w->tabela[h] != 0 && w->tabela[h] != pos + 1; h = (h + 1) & w->mascara);
+        if (w->tabela[h] == 0) {
+            w->tabela[h] = pos + 1;
+            w->ocupadas[usadas++] = h;
+            novas++;
+        }
+    }
+
+    //Só as entradas usadas são limpas, para a próxima candidata não pagar o tamanho da tabela
+    for (int i = 0; i < usadas; i++) {
+        w->tabela[w->ocupadas[i]] = 0;
+    }
+    return novas;
+}
+
+/// @brief Ciclo de cada thread de avaliarCandidatos: vai buscando blocos de candidatas até não haver mais
+static void* trabalhadorCandidatos(void* arg) {
+    ArgumentoThread* a = (ArgumentoThread*)arg;
+    TrabalhoParalelo* t = a->t;
+    TrabalhoCandidata w;
+    int pontos = 2 * maiorGrupo(&t->estado->grupos) + 1;
+    size_t tamanho = 16;
+    int i;
+
+    //A tabela tem pelo menos o dobro das entradas dos pontos de uma candidata, para as sondagens serem curtas
+    while (tamanho < 2 * (size_t)pontos) {
+        tamanho *= 2;
+    }
+    w.mascara = tamanho - 1;
+    w.rx = (int*)malloc((size_t)pontos * sizeof(int));
+    w.ry = (int*)malloc((size_t)pontos * sizeof(int));
+    w.tabela = (size_t*)calloc(tamanho, sizeof(size_t));
+    w.ocupadas = (size_t*)malloc((size_t)pontos * sizeof(size_t));
+
+    if (w.rx == NULL || w.ry == NULL || w.tabela == NULL || w.ocupadas == NULL) {
+        atomic_store(&t->erro, true);
+    } else {
+        while ((i = atomic_fetch_add(&t->proxima, 1)) < t->numTarefas) {
+            int fim = (i + 1) * CANDIDATOS_POR_TAREFA;
+            if (fim > t->numCandidatos) {
+                fim = t->numCandidatos;
+            }
+            for (int c = i * CANDIDATOS_POR_TAREFA; c < fim; c++) {
+                t->resultados[c] = avaliarCandidata(t->estado, &t->candidatos[c], &w);
+            }
+        }
+    }
+
+    free(w.rx);
+    free(w.ry);
+    free(w.tabela);
+    free(w.ocupadas);
+    return NULL;
+}
+
+/// @brief Calcula, para cada posição candidata, quantas novas posições com efeito nefasto apareceriam se lá fosse colocada a antena, sem alterar o estado
+/// @param e Apontador para o estado (não é alterado)
+/// @param candidatos Vetor com as posições candidatas
+/// @param n Número de candidatas
+/// @param resultado Vetor com n posições onde é escrito, para cada candidata, o número de novas posições com efeito nefasto (-1 se a frequência não for válida ou se a posição estiver fora do mapa ou ocupada)
+/// @param numThreads Número de threads (0 ou negativo para usar todos os processadores, 1 para não criar threads)
+/// @return Devolve false se os parâmetros não forem válidos ou se não conseguir alocar espaço
+bool avaliarCandidatos(EstadoNefasto* e, const CandidatoAntena* candidatos, int n, long* resultado, int numThreads) {
+    TrabalhoParalelo t;
+
+    if (e == NULL || n < 0 || (n > 0 && (candidatos == NULL || resultado == NULL))) {
+        return false;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    t.estado = e;
+    t.candidatos = candidatos;
+    t.numCandidatos = n;
+    t.resultados = resultado;
+    t.numTarefas = (n + CANDIDATOS_POR_TAREFA - 1) / CANDIDATOS_POR_TAREFA;
+    atomic_init(&t.erro, false);
+    atomic_init(&t.proxima, 0);
+
+    if (numThreads <= 0) {
+        numThreads = processadoresDisponiveis();
+    }
+    //Não vale a pena ter mais threads do que blocos de candidatas
+    if (numThreads > t.numTarefas) {
+        numThreads = (t.numTarefas > 0) ? t.numTarefas : 1;
+    }
+    t.numThreads = numThreads;
+
+    //O estado só é lido, por isso as threads não precisam de sincronização além do índice do próximo bloco
+    correrThreads(&t, trabalhadorCandidatos);
+    if (atomic_load(&t.erro)) {
+        return false;
+    }
+    TERMINAR_TEMPO(tempoInicio, FASE_CANDIDATOS);
+    return true;
+}
+
+/// @brief Cria a lista ordenada, sem repetições, das posições com efeito nefasto do estado
+/// @param e Apontador para o estado
+/// @return Devolve a lista de efeitos nefastos
+Nefasto* nefastosDoEstado(EstadoNefasto* e) {
+    Nefasto* lista = NULL;
+    Nefasto* ultimo = NULL;
+    Nefasto* novo;
+
+    if (e == NULL) {
+        return NULL;
+    }
+
+    for (int x = 0; x < e->mapa->linhas; x++) {
+        unsigned int* linha = e->contagem + (size_t)x * (size_t)e->mapa->colunas;
+        for (int y = 0; y < e->mapa->colunas; y++) {
+            if (linha[y] > 0) {
+                novo = criarNefastoMapa(e->mapa, x, y);
+                if (novo == NULL) {
+                    return lista;
+                }
+                if (ultimo == NULL) {
+                    lista = novo;
+                } else {
+                    ultimo->prox = novo;
+                }
+                ultimo = novo;
+            }
+        }
+    }
+    return lista;
+}
+
+/// @brief Liberta a memória ocupada pelo estado (o mapa não é libertado)
+/// @param e Apontador para o estado a libertar
+void libertarEstadoNefasto(EstadoNefasto* e) {
+    if (e != NULL) {
+        libertarFrequencias(&e->grupos);
+        free(e->contagem);
+        free(e->antenaEm);
+        free(e->rx);
+        free(e->ry);
+        free(e);
+    }
+}
+
+/// @brief Função que imprime as posições dos efeitos nefastos em forma tabular
+/// @param h Apontador para o início da lista de efeitos nefastos
+bool imprimirNefasto(Nefasto* h) {
+    Nefasto* aux = h;   //Apontador auxiliar (aux) que aponta para o início da lista (h)
+
+    if (h == NULL) {
+        return false;
+    }
+
+    //Percorre a lista efeitos nefasto enquanto o proxímo elemento não é nulo, ou seja, percorre até ao final da lista ligada
+    while (aux != NULL) {
+        printf("| (%2d,%2d) |\n", aux->x, aux->y);
+        aux = aux -> prox; //Avança para a próxima posição da lista
+    }
+
+    return true;
+}
+
+
+/// @brief Escreve o mapa com as antenas e as localizações com efeito nefasto (#) num ficheiro, de uma só vez
+/// @param fp Ficheiro de saída (por exemplo stdout)
+/// @param mapa Apontador para o mapa com as dimensões e a lista de antenas
+/// @param h Apontador para o início da lista de efeitos nefastos (pode ser NULL)
+/// @param g Apontador para a grelha de efeitos nefastos (pode ser NULL)
+/// @return Devolve false se o mapa não existir ou se não conseguir alocar espaço para o quadro
+bool escreverAntenasNefasto(FILE* fp, Mapa* mapa, Nefasto* h, GrelhaBits* g) {
+    char* quadro;
+    size_t largura, tamanho, palavras, i;
+    uint64_t palavra;
+    int linha;
+
+    if (fp == NULL || mapa == NULL) {
+        return false;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    //O quadro tem uma linha de texto por linha do mapa, cada uma terminada com '\n'
+    largura = (size_t)mapa->colunas + 1;
+    tamanho = (size_t)mapa->linhas * largura;
+    quadro = (char*)malloc(tamanho > 0 ? tamanho : 1);
+    if (quadro == NULL) {
+        return false;
+    }
+
+    //Começa com todas as posições vazias
+    for (linha = 0; linha < mapa->linhas; linha++) {
+        memset(quadro + (size_t)linha * largura, '.', (size_t)mapa->colunas);
+        quadro[(size_t)linha * largura + (size_t)mapa->colunas] = '\n';
+    }
+
+    //Coloca cada antena na sua posição
+    for (Antena* aux = mapa->antenas; aux != NULL; aux = aux->prox) {
+        if (dentroDoMapa(mapa, aux->x, aux->y)) {
+            quadro[(size_t)aux->x * largura + (size_t)aux->y] = aux->freq;
+        }
+    }
+
+    //Substitui por '#' as posições da lista de efeitos nefastos
+    for (Nefasto* aux = h; aux != NULL; aux = aux->prox) {
+        if (dentroDoMapa(mapa, aux->x, aux->y)) {
+            quadro[(size_t)aux->x * largura + (size_t)aux->y] = '#';
+        }
+    }
+
+    //Substitui por '#' as posições marcadas na grelha (só os bits ligados são visitados)
+    if (g != NULL && g->linhas == mapa->linhas && g->colunas == mapa->colunas) {
+        palavras = ((size_t)g->linhas * (size_t)g->colunas + 63) / 64;
+        for (i = 0; i < palavras; i++) {
+            palavra = g->bits[i];
+            while (palavra != 0) {
+                size_t posicao = i * 64 + (size_t)__builtin_ctzll(palavra);
+                palavra &= palavra - 1;
+                quadro[(posicao / (size_t)g->colunas) * largura + posicao % (size_t)g->colunas] = '#';
+            }
+        }
+    }
+
+    //Escreve o quadro completo com uma única escrita
+    fwrite(quadro, 1, tamanho, fp);
+    free(quadro);
+    CONTAR(bytesEscritos, tamanho);
+    TERMINAR_TEMPO(tempoInicio, FASE_ESCREVER);
+    return true;
+}
+
+/// @brief Imprime o mapa com as antenas e adiciona as localizações com efeito nefasto (#)
+/// @param mapa Apontador para o mapa com as dimensões e a lista de antenas
+/// @param h Apontador para o início da lista de efeitos nefastos
+bool imprimirAntenasNefasto(Mapa* mapa, Nefasto* h) {
+    return escreverAntenasNefasto(stdout, mapa, h, NULL);
+}
+
+#define BANDA_BITS_OMISSAO ((size_t)1 << 26)   //Tamanho por omissão da grelha de uma banda (8 MB de bits)
+#define LINHA_CAPACIDADE_INICIAL 256
+
+/// @brief Lê uma linha completa de um ficheiro de texto, aumentando o buffer se a linha não couber
+/// @param fp Ficheiro de entrada
+/// @param linha Apontador para o buffer da linha (realocado se for preciso)
+/// @param capacidade Apontador para o tamanho do buffer
+/// @param largura Apontador onde é devolvido o número de caracteres da linha, sem o fim de linha
+/// @return Devolve 1 se leu uma linha, 0 no fim do ficheiro e -1 se não conseguir alocar espaço
+static int lerLinhaFicheiro(FILE* fp, char** linha, size_t* capacidade, int* largura) {
+    size_t n = 0;
+    char* novo;
+
+    while (fgets(*linha + n, (int)(*capacidade - n), fp) != NULL) {
+        n += strlen(*linha + n);
+        if (n == 0 || (*linha)[n - 1] == '\n' || feof(fp)) {
+            break;
+        }
+
+        //A linha não coube no buffer: duplica-o e continua a leitura
+        novo = (char*)realloc(*linha, *capacidade * 2);
+        if (novo == NULL) {
+            return -1;
+        }
+        *linha = novo;
+        *capacidade *= 2;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    //Tal como em lerRegistosMapa, o fim de linha ("\n" ou "\r\n") não conta para a largura
+    if ((*linha)[n - 1] == '\n') {
+        n--;
+    }
+    if (n > 0 && (*linha)[n - 1] == '\r') {
+        n--;
+    }
+    *largura = (int)n;
+    return 1;
+}
+
+/// @brief Devolve a primeira posição de um vetor ordenado com valor maior ou igual a v
+/// @param xs Vetor ordenado por ordem crescente
+/// @param n Número de elementos do vetor
+/// @param v Valor procurado
+/// @return Devolve a posição encontrada (n se todos os valores forem menores que v)
+static int primeiroMaiorOuIgual(const int* xs, int n, int v) {
+    int inicio = 0, fim = n, meio;
+
+    while (inicio < fim) {
+        meio = inicio + (fim - inicio) / 2;
+        if (xs[meio] < v) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    return inicio;
+}
+
+/// @brief Marca numa grelha as posições com efeito nefasto cujas linhas pertencem a uma banda do mapa
+/// @param f Grupos de frequência, com as antenas de cada grupo por ordem crescente de linha
+/// @param inicio Primeira linha da banda
+/// @param fim Linha a seguir à última linha da banda
+/// @param colunas Número de colunas do mapa
+/// @param banda Grelha da banda (a linha inicio do mapa corresponde à linha 0 da grelha)
+static void marcarBanda(Frequencias* f, int inicio, int fim, int colunas, GrelhaBits* banda) {
+    GrupoFrequencia* g;
+    int a, j, ultimo, px, py;
+
+    for (int k = 0; k < NUM_FREQ; k++) {
+        g = &f->grupos[k];
+        if (g->n < 2) {
+            continue;
+        }
+
+        //O ponto 2A - B está na banda se inicio <= 2*xa - xb < fim, ou seja, se 2*xa - fim < xb <= 2*xa - inicio;
+        //só as antenas A com xa entre (menor x + inicio) / 2 e (maior x + fim - 1) / 2 podem ter parceiras assim
+        a = primeiroMaiorOuIgual(g->x, g->n, (g->x[0] + inicio + 1) / 2);
+        ultimo = (g->x[g->n - 1] + fim - 1) / 2;
+
+        //Cada par ordenado (A, B) dá um dos dois pontos do par, por isso os dois pontos são cobertos
+        for (; a < g->n && g->x[a] <= ultimo; a++) {
+            j = primeiroMaiorOuIgual(g->x, g->n, 2 * g->x[a] - fim + 1);
+            for (; j < g->n && g->x[j] <= 2 * g->x[a] - inicio; j++) {
+                CONTAR(paresComparados, 1);
+                py = 2 * g->y[a] - g->y[j];
+                if (j == a || (unsigned)py >= (unsigned)colunas) {
+                    continue;
+                }
+                px = 2 * g->x[a] - g->x[j];
+                marcarGrelhaBits(banda, px - inicio, py);
+            }
+        }
+    }
+}
+
+/// @brief Calcula os efeitos nefastos de um mapa em ficheiro sem o carregar por completo, banda de linhas a banda de linhas
+/// @param nomeEntrada Nome do ficheiro de texto com o mapa
+/// @param nomeSaida Nome do ficheiro onde é escrito o mapa com os efeitos nefastos (#), ou NULL para só contar
+/// @param linhasPorBanda Número de linhas de cada banda (0 ou negativo para escolher pelo tamanho das linhas)
+/// @return Devolve o número de posições diferentes com efeito nefasto, ou -1 se um ficheiro não abrir ou não conseguir alocar espaço
+long processarMapaEmBandas(char* nomeEntrada, char* nomeSaida, int linhasPorBanda) {
+    FILE* entrada;
+    FILE* saida = NULL;
+    Frequencias f;
+    GrelhaBits* banda = NULL;
+    char* linha;
+    char* quadro = NULL;
+    size_t capacidade = LINHA_CAPACIDADE_INICIAL;
+    int linhas = 0, colunas = 0, largura, lido, fim, i;
+    const char* p;
+    long total = 0;
+    bool ok = true;
+
+    INICIAR_TEMPO(tempoInicio);
+    entrada = fopen(nomeEntrada, "r");
+    if (entrada == NULL) {
+        return -1;
+    }
+    linha = (char*)malloc(capacidade);
+    if (linha == NULL) {
+        fclose(entrada);
+        return -1;
+    }
+    for (i = 0; i < NUM_FREQ; i++) {
+        f.grupos[i].n = 0;
+        f.grupos[i].capacidade = 0;
+        f.grupos[i].x = NULL;
+        f.grupos[i].y = NULL;
+    }
+
+    //1.ª passagem: só ficam em memória as coordenadas das antenas, já ordenadas por linha dentro de cada grupo
+    while (ok && (lido = lerLinhaFicheiro(entrada, &linha, &capacidade, &largura)) > 0) {
+        if (largura > colunas) {
+            colunas = largura;
+        }
+        p = procurarNaoPonto(linha, linha + largura);
+        while (ok && p < linha + largura) {
+            i = indiceFrequencia(*p);
+            if (i >= 0) {
+                ok = adicionarAoGrupo(&f.grupos[i], linhas, (int)(p - linha));
+            }
+            p = procurarNaoPonto(p + 1, linha + largura);
+        }
+        linhas++;
+    }
+    ok = ok && lido == 0;
+    CONTAR(bytesLidos, ftell(entrada));
+
+    //A banda é escolhida para que a sua grelha tenha um tamanho fixo, qualquer que seja a largura do mapa
+    if (linhasPorBanda <= 0) {
+        linhasPorBanda = (colunas > 0) ? (int)(BANDA_BITS_OMISSAO / (size_t)colunas) : 1;
+        if (linhasPorBanda < 1) {
+            linhasPorBanda = 1;
+        }
+    }
+    if (linhasPorBanda > linhas) {
+        linhasPorBanda = (linhas > 0) ? linhas : 1;
+    }
+
+    if (ok) {
+        banda = criarGrelhaBits(linhasPorBanda, colunas);
+        quadro = (char*)malloc((size_t)colunas + 1);
+        ok = banda != NULL && quadro != NULL;
+    }
+    if (ok && nomeSaida != NULL) {
+        saida = fopen(nomeSaida, "w");
+        ok = saida != NULL;
+        rewind(entrada);
+    }
+
+    //2.ª passagem: cada banda é calculada numa grelha própria e escrita logo a seguir
+    for (int inicio = 0; ok && inicio < linhas; inicio += linhasPorBanda) {
+        fim = (inicio + linhasPorBanda < linhas) ? inicio + linhasPorBanda : linhas;
+        memset(banda->bits, 0, (((size_t)linhasPorBanda * (size_t)colunas + 63) / 64) * sizeof(uint64_t));
+        banda->contagem = 0;
+        marcarBanda(&f, inicio, fim, colunas, banda);
+        total += banda->contagem;
+
+        //Volta a ler as linhas da banda e escreve-as com as antenas e os efeitos nefastos, como escreverAntenasNefasto
+        for (int x = inicio; saida != NULL && x < fim; x++) {
+            if (lerLinhaFicheiro(entrada, &linha, &capacidade, &largura) <= 0) {
+                ok = false;
+                break;
+            }
+            for (int y = 0; y < colunas; y++) {
+                if (testarGrelhaBits(banda, x - inicio, y)) {
+                    quadro[y] = '#';
+                } else if (y < largura && indiceFrequencia(linha[y]) >= 0) {
+                    quadro[y] = linha[y];
+                } else {
+                    quadro[y] = '.';
+                }
+            }
+            quadro[colunas] = '\n';
+            fwrite(quadro, 1, (size_t)colunas + 1, saida);
+            CONTAR(bytesEscritos, colunas + 1);
+        }
+    }
+    if (saida != NULL) {
+        CONTAR(bytesLidos, ftell(entrada));
+    }
+
+    if (saida != NULL && fclose(saida) != 0) {
+        ok = false;
+    }
+    fclose(entrada);
+    free(linha);
+    free(quadro);
+    libertarGrelhaBits(banda);
+    libertarFrequencias(&f);
+    if (ok) {
+        TERMINAR_TEMPO(tempoInicio, FASE_BANDAS);
+    }
+    return ok ? total : -1;
+}
+
+/*
+* Tabela de antenas: em vez de um nó por antena, a frequência, o x e o y de todas as antenas ficam em
+* três vetores contíguos, ordenados por (frequência, x, y). Cada grupo de frequência ocupa posições
+* seguidas e, dentro do grupo, as antenas da mesma linha também, por isso os percursos por grupo,
+* as procuras binárias e os intervalos de linhas só leem memória compacta.
+*
+* A ordenação é um radix sort LSD: primeiro as coordenadas (um byte de cada vez, saltando os bytes
+* iguais em todas as antenas) e por fim uma contagem por frequência, que também preenche inicioGrupo.
+* Cada passagem é estável, por isso a ordem final é (frequência, x, y) sem nenhuma comparação.
+*/
+
+/// @brief Cria uma tabela vazia com espaço para um número de antenas
+/// @param capacidade Número de antenas a reservar
+/// @return Devolve a nova tabela ou NULL se não conseguir alocar espaço
+static TabelaAntenas* novaTabelaAntenas(int capacidade) {
+    TabelaAntenas* t = (TabelaAntenas*)calloc(1, sizeof(TabelaAntenas));
+    size_t reservar = (capacidade > 0) ? (size_t)capacidade : 1;
+
+    if (t == NULL) {
+        return NULL;
+    }
+    t->freq = (char*)malloc(reservar * sizeof(char));
+    t->x = (int*)malloc(reservar * sizeof(int));
+    t->y = (int*)malloc(reservar * sizeof(int));
+    if (t->freq == NULL || t->x == NULL || t->y == NULL) {
+        libertarTabelaAntenas(t);
+        return NULL;
+    }
+    t->capacidade = (int)reservar;
+    return t;
+}
+
+/// @brief Junta as duas coordenadas numa chave sem sinal com a mesma ordem que (x, y)
+/// @param x Coordenada x
+/// @param y Coordenada y
+/// @return Devolve a chave (o bit de sinal é trocado para os valores negativos ficarem primeiro)
+static inline uint64_t chaveCoordenadas(int x, int y) {
+    return ((uint64_t)((uint32_t)x ^ 0x80000000u) << 32) | (uint64_t)((uint32_t)y ^ 0x80000000u);
+}
+
+/// @brief Ordena a tabela por (frequência, x, y) com um radix sort
+/// @param t Apontador para a tabela (só com frequências válidas)
+/// @param porCoordenadas false se as antenas já estiverem por ordem de (x, y), como na leitura de um ficheiro
+/// @return Devolve false se não conseguir alocar espaço (a tabela fica como estava)
+static bool ordenarTabela(TabelaAntenas* t, bool porCoordenadas) {
+    size_t reservar = (t->n > 0) ? (size_t)t->n : 1;
+    int* ordem = (int*)malloc(reservar * sizeof(int));
+    int* ordemAux = (int*)malloc(reservar * sizeof(int));
+    uint64_t* chaves = NULL;
+    uint64_t* chavesAux = NULL;
+    char* freq = (char*)malloc(reservar * sizeof(char));
+    int* x = (int*)malloc(reservar * sizeof(int));
+    int* y = (int*)malloc(reservar * sizeof(int));
+    int contagem[256];
+    bool ok = (ordem != NULL && ordemAux != NULL && freq != NULL && x != NULL && y != NULL);
+    int i, k;
+
+    if (ok && porCoordenadas) {
+        chaves = (uint64_t*)malloc(reservar * sizeof(uint64_t));
+        chavesAux = (uint64_t*)malloc(reservar * sizeof(uint64_t));
+        ok = (chaves != NULL && chavesAux != NULL);
+    }
+    if (!ok) {
+        free(ordem);
+        free(ordemAux);
+        free(chaves);
+        free(chavesAux);
+        free(freq);
+        free(x);
+        free(y);
+        return false;
+    }
+
+    for (i = 0; i < t->n; i++) {
+        ordem[i] = i;
+    }
+
+    //1) Coordenadas: uma passagem estável por cada byte da chave, do menos para o mais significativo
+    if (porCoordenadas && t->n > 1) {
+        for (i = 0; i < t->n; i++) {
+            chaves[i] = chaveCoordenadas(t->x[i], t->y[i]);
+        }
+        for (int desloc = 0; desloc < 64; desloc += 8) {
+            memset(contagem, 0, sizeof(contagem));
+            for (i = 0; i < t->n; i++) {
+                contagem[(chaves[i] >> desloc) & 0xFF]++;
+            }
+            //Se todas as antenas têm o mesmo byte, esta passagem não muda a ordem
+            if (contagem[(chaves[0] >> desloc) & 0xFF] == t->n) {
+                continue;
+            }
+            for (k = 0, i = 0; k < 256; k++) {
+                int c = contagem[k];
+                contagem[k] = i;
+                i += c;
+            }
+            for (i = 0; i < t->n; i++) {
+                int pos = contagem[(chaves[i] >> desloc) & 0xFF]++;
+                chavesAux[pos] = chaves[i];
+                ordemAux[pos] = ordem[i];
+            }
+            uint64_t* trocaChaves = chaves;
+            chaves = chavesAux;
+            chavesAux = trocaChaves;
+            int* trocaOrdem = ordem;
+            ordem = ordemAux;
+            ordemAux = trocaOrdem;
+        }
+    }
+
+    //2) Frequência: contagem por grupo, que dá logo o início de cada grupo na tabela
+    memset(t->inicioGrupo, 0, sizeof(t->inicioGrupo));
+    for (i = 0; i < t->n; i++) {
+        t->inicioGrupo[indiceFrequencia(t->freq[i]) + 1]++;
+    }
+    for (k = 0; k < NUM_FREQ; k++) {
+        t->inicioGrupo[k + 1] += t->inicioGrupo[k];
+        contagem[k] = t->inicioGrupo[k];
+    }
+    for (i = 0; i < t->n; i++) {
+        int origem = ordem[i];
+        int pos = contagem[indiceFrequencia(t->freq[origem])]++;
+        freq[pos] = t->freq[origem];
+        x[pos] = t->x[origem];
+        y[pos] = t->y[origem];
+    }
+
+    free(t->freq);
+    free(t->x);
+    free(t->y);
+    t->freq = freq;
+    t->x = x;
+    t->y = y;
+    t->capacidade = (int)reservar;
+
+    free(ordem);
+    free(ordemAux);
+    free(chaves);
+    free(chavesAux);
+    return true;
+}
+
+/// @brief Carrega as antenas de um ficheiro de texto para uma tabela ordenada por (frequência, x, y)
+/// @param nomeFicheiro Nome do ficheiro de texto com o mapa
+/// @return Devolve a tabela ordenada com as antenas do mapa, ou NULL se o ficheiro não abrir ou não conseguir alocar espaço
+TabelaAntenas* carregarTabelaAntenas(char* nomeFicheiro) {
+    char* dados;
+    size_t tamanho;
+    RegistoAntena* registos = NULL;
+    int n, linhas, colunas;
+    TabelaAntenas* t;
+
+    INICIAR_TEMPO(tempoInicio);
+
+    dados = mapearFicheiro(nomeFicheiro, &tamanho);
+    if (dados == NULL) {
+        return NULL;
+    }
+    CONTAR(bytesLidos, tamanho);
+
+    if (!lerRegistosMapa(dados, tamanho, &registos, &n, &linhas, &colunas)) {
+        desmapearFicheiro(dados, tamanho);
+        return NULL;
+    }
+    desmapearFicheiro(dados, tamanho);
+
+    t = novaTabelaAntenas(n);
+    if (t == NULL) {
+        free(registos);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        t->freq[i] = registos[i].freq;
+        t->x[i] = registos[i].x;
+        t->y[i] = registos[i].y;
+    }
+    t->n = n;
+    t->linhas = linhas;
+    t->colunas = colunas;
+    free(registos);
+
+    //O ficheiro é lido linha a linha, por isso os registos já estão por (x, y) e só falta a passagem da frequência
+    if (!ordenarTabela(t, false)) {
+        libertarTabelaAntenas(t);
+        return NULL;
+    }
+    TERMINAR_TEMPO(tempoInicio, FASE_CARREGAR);
+    return t;
+}
+
+/// @brief Cria uma tabela ordenada com as antenas de uma lista ligada
+/// @param h Apontador para o início da lista de antenas (em qualquer ordem)
+/// @return Devolve a tabela ordenada com as antenas da lista, ou NULL se não conseguir alocar espaço
+TabelaAntenas* criarTabelaAntenas(Antena* h) {
+    TabelaAntenas* t;
+    int n = 0;
+
+    for (Antena* aux = h; aux != NULL; aux = aux->prox) {
+        n++;
+    }
+    t = novaTabelaAntenas(n);
+    if (t == NULL) {
+        return NULL;
+    }
+
+    //As antenas com frequências inválidas não têm grupo, por isso ficam fora da tabela
+    for (Antena* aux = h; aux != NULL; aux = aux->prox) {
+        if (indiceFrequencia(aux->freq) >= 0) {
+            t->freq[t->n] = aux->freq;
+            t->x[t->n] = aux->x;
+            t->y[t->n] = aux->y;
+            t->n++;
+        }
+    }
+
+    if (!ordenarTabela(t, true)) {
+        libertarTabelaAntenas(t);
+        return NULL;
+    }
+    return t;
+}
+
+/// @brief Volta a ordenar uma tabela por (frequência, x, y), por exemplo depois de lhe acrescentar antenas no fim
+/// @param t Apontador para a tabela (os vetores podem estar em qualquer ordem, só com frequências válidas)
+/// @return Devolve false se não conseguir alocar espaço (a tabela fica como estava)
+bool ordenarTabelaAntenas(TabelaAntenas* t) {
+    if (t == NULL) {
+        return false;
+    }
+    return ordenarTabela(t, true);
+}
+
+/// @brief Devolve as posições das antenas de uma frequência
+/// @param t Apontador para a tabela
+/// @param freq Frequência pedida
+/// @param inicio Apontador onde é devolvida a posição da primeira antena do grupo
+/// @return Devolve o número de antenas com a frequência (0 se a frequência não for válida)
+int grupoTabelaAntenas(const TabelaAntenas* t, char freq, int* inicio) {
+    int k = indiceFrequencia(freq);
+
+    *inicio = 0;
+    if (t == NULL || k < 0) {
+        return 0;
+    }
+    *inicio = t->inicioGrupo[k];
+    return t->inicioGrupo[k + 1] - t->inicioGrupo[k];
+}
+
+/// @brief Procura binária da primeira antena de [inicio, fim) com (x, y) maior ou igual ao indicado
+/// @param t Apontador para a tabela
+/// @param inicio Primeira posição do intervalo
+/// @param fim Posição a seguir à última do intervalo
+/// @param x Coordenada x procurada
+/// @param y Coordenada y procurada
+/// @return Devolve a posição encontrada (fim se todas forem menores)
+static int limiteInferiorTabela(const TabelaAntenas* t, int inicio, int fim, int x, int y) {
+    while (inicio < fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        if (t->x[meio] < x || (t->x[meio] == x && t->y[meio] < y)) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    return inicio;
+}
+
+/// @brief Procura uma antena na tabela com uma procura binária dentro do grupo da sua frequência
+/// @param t Apontador para a tabela
+/// @param freq Frequência da antena
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @return Devolve a posição da antena na tabela, ou -1 se não existir
+int procurarAntenaTabela(const TabelaAntenas* t, char freq, int x, int y) {
+    int inicio, n, i;
+
+    n = grupoTabelaAntenas(t, freq, &inicio);
+    i = limiteInferiorTabela(t, inicio, inicio + n, x, y);
+    if (i < inicio + n && t->x[i] == x && t->y[i] == y) {
+        return i;
+    }
+    return -1;
+}
+
+/// @brief Encontra as antenas de uma frequência cujas linhas estão num intervalo
+/// @param t Apontador para a tabela
+/// @param freq Frequência das antenas
+/// @param x1 Primeira linha do intervalo
+/// @param x2 Última linha do intervalo
+/// @param inicio Apontador onde é devolvida a posição da primeira antena do intervalo
+/// @return Devolve o número de antenas com a frequência e x1 <= x <= x2 (ocupam posições seguidas a partir de *inicio)
+int intervaloLinhasTabela(const TabelaAntenas* t, char freq, int x1, int x2, int* inicio) {
+    int primeiro, n, fim;
+
+    n = grupoTabelaAntenas(t, freq, &primeiro);
+    if (n == 0 || x1 > x2) {
+        *inicio = primeiro;
+        return 0;
+    }
+
+    //Dentro do grupo as antenas estão por linha, por isso o intervalo é contíguo
+    *inicio = limiteInferiorTabela(t, primeiro, primeiro + n, x1, INT_MIN);
+    fim = (x2 == INT_MAX) ? primeiro + n : limiteInferiorTabela(t, *inicio, primeiro + n, x2 + 1, INT_MIN);
+    return fim - *inicio;
+}
+
+/// @brief Liberta a memória ocupada por uma tabela de antenas
+/// @param t Apontador para a tabela a libertar
+void libertarTabelaAntenas(TabelaAntenas* t) {
+    if (t == NULL) {
+        return;
+    }
+    free(t->freq);
+    free(t->x);
+    free(t->y);
+    free(t);
+}
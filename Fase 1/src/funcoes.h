@@ -10,13 +10,14 @@
 
 #ifndef FUNCOES_H
 #define FUNCOES_H  
+#include <stdio.h>
 #include <stdbool.h>
-#define MAXi 12             //Máximo número de linhas
-#define MAXj 12             //Máximo número de colunas
+#include <stdint.h>
+#define NUM_FREQ 62         //Número de frequências possíveis (A-Z, a-z, 0-9)
 
 /// @brief Estrutura que representa uma antena no mapa
 typedef struct Antena {
-    char freq;              //Frequência da antena (A-Z, a-z)
+    char freq;              //Frequência da antena (A-Z, a-z, 0-9)
     int x, y;               //Coordenadas (linha, coluna)
     struct Antena* prox;    //Apontador para a próxima antena da lista
 }Antena;
@@ -27,6 +28,154 @@ typedef struct Nefasto {
     struct Nefasto* prox;   //Apontador para o próximo efeito na lista
 }Nefasto;
 
+/// @brief Estrutura que representa um bloco de memória de uma pool (os elementos ficam a seguir)
+typedef struct BlocoPool {
+    struct BlocoPool* prox; //Bloco seguinte
+}BlocoPool;
+
+/// @brief Estrutura que entrega nós do mesmo tamanho a partir de blocos contíguos e reaproveita os nós devolvidos
+typedef struct Pool {
+    size_t tamanho;         //Tamanho de cada elemento (arredondado ao alinhamento)
+    int porBloco;           //Número de elementos do próximo bloco a alocar
+    BlocoPool* blocos;      //Lista dos blocos alocados
+    char* proximo;          //Próximo elemento por usar no bloco atual
+    int restantes;          //Elementos por usar no bloco atual
+    void* livres;           //Lista de elementos devolvidos, prontos a reutilizar
+    long emUso;             //Elementos entregues e ainda não devolvidos
+    long pedidos;           //Total de pedidos de elementos
+    long reutilizados;      //Pedidos servidos pela lista de livres
+    int numBlocos;          //Número de blocos alocados
+    size_t bytes;           //Total de bytes alocados em blocos
+}Pool;
+
+/// @brief Estrutura que representa um mapa de antenas e as suas dimensões, lidas do ficheiro
+/// Os nós da lista de antenas e das listas de efeitos nefastos criadas com a memória do mapa pertencem às pools do mapa:
+/// não podem ser libertados com free nem com removerAntena (usar removerAntenaMapa, libertarNefasto(mapa, ...) ou libertarMapa)
+typedef struct Mapa {
+    int linhas;             //Número de linhas do mapa
+    int colunas;            //Número de colunas do mapa (comprimento da maior linha)
+    Antena* antenas;        //Lista ligada das antenas do mapa (nós da poolAntenas)
+    Pool poolAntenas;       //Memória das antenas do mapa
+    Pool poolNefastos;      //Memória dos efeitos nefastos calculados para o mapa
+}Mapa;
+
+/// @brief Verifica se uma posição está dentro dos limites do mapa
+/// @param m Apontador para o mapa
+/// @param x Coordenada x (linha)
+/// @param y Coordenada y (coluna)
+/// @return Devolve true se 0 <= x < linhas e 0 <= y < colunas
+static inline bool dentroDoMapa(const Mapa* m, int x, int y) {
+    //Com a conversão para unsigned, os valores negativos ficam enormes e cada eixo precisa de uma só comparação
+    return (unsigned)x < (unsigned)m->linhas && (unsigned)y < (unsigned)m->colunas;
+}
+
+/// @brief Estrutura que representa uma grelha de bits com um bit por cada posição do mapa
+typedef struct GrelhaBits {
+    int linhas, colunas;    //Dimensões da grelha
+    long contagem;          //Número de posições marcadas
+    uint64_t* bits;         //Bits das posições, guardados linha a linha
+}GrelhaBits;
+
+/// @brief Estrutura que agrupa as coordenadas das antenas com a mesma frequência em vetores contíguos
+typedef struct GrupoFrequencia {
+    int n;                  //Número de antenas do grupo
+    int capacidade;         //Número de posições alocadas nos vetores
+    int* x;                 //Linhas das antenas do grupo
+    int* y;                 //Colunas das antenas do grupo
+}GrupoFrequencia;
+
+/// @brief Estrutura com um grupo de antenas por cada frequência possível
+typedef struct Frequencias {
+    GrupoFrequencia grupos[NUM_FREQ];   //Grupos indexados por indiceFrequencia
+}Frequencias;
+
+
+/// @brief Estrutura que mantém os efeitos nefastos de um mapa atualizados à medida que as antenas mudam
+/// Enquanto o estado existir, a lista de antenas do mapa só deve ser alterada com inserirAntenaEstado e removerAntenaEstado
+typedef struct EstadoNefasto {
+    Mapa* mapa;                 //Mapa acompanhado (a lista de antenas é atualizada em conjunto)
+    Frequencias grupos;         //Antenas do mapa agrupadas por frequência
+    unsigned int* contagem;     //Número de pares de antenas que criam efeito nefasto em cada posição
+    Antena** antenaEm;          //Antena (nó da lista do mapa) em cada posição, ou NULL se a posição estiver livre
+    long unicos;                //Número de posições com contagem maior que zero
+    int* rx;                    //Vetores auxiliares para os pontos calculados
+    int* ry;
+    int capacidade;             //Número de posições alocadas em rx e ry
+}EstadoNefasto;
+
+/// @brief Estrutura que representa uma posição candidata para uma nova antena
+typedef struct CandidatoAntena {
+    char freq;              //Frequência da antena a colocar
+    int x, y;               //Posição da antena a colocar
+}CandidatoAntena;
+
+/// @brief Estrutura que guarda as antenas em vetores contíguos (um por campo), ordenadas por (frequência, x, y)
+typedef struct TabelaAntenas {
+    int n;                          //Número de antenas
+    int capacidade;                 //Número de posições alocadas em cada vetor
+    char* freq;                     //Frequência de cada antena
+    int* x;                         //Linha de cada antena
+    int* y;                         //Coluna de cada antena
+    int inicioGrupo[NUM_FREQ + 1];  //As antenas da frequência k estão nas posições [inicioGrupo[k], inicioGrupo[k+1])
+    int linhas, colunas;            //Dimensões do mapa lido (0 se a tabela for criada a partir de uma lista)
+}TabelaAntenas;
+
+/// @brief Fases da biblioteca cujo tempo é medido pela instrumentação
+typedef enum FaseEstatistica {
+    FASE_CARREGAR,          //carregarMapa (e carregarAntenas)
+    FASE_NEFASTO,           //efeitoNefasto, efeitoNefastoGrelha, efeitoNefastoParalelo e efeitoNefastoHarmonicos
+    FASE_BANDAS,            //processarMapaEmBandas
+    FASE_ESTADO,            //criarEstadoNefasto
+    FASE_ESCREVER,          //escreverAntenasNefasto
+    FASE_GRAVAR,            //gravarFicheiroBinario
+    FASE_CANDIDATOS,        //avaliarCandidatos
+    NUM_FASES_ESTATISTICA
+}FaseEstatistica;
+
+/// @brief Estrutura com os contadores da instrumentação (só são atualizados se a biblioteca for compilada com EDA_ESTATISTICAS)
+typedef struct Estatisticas {
+    long alocacoes;                             //Nós pedidos (malloc ou pool)
+    long passosLista;                           //Nós percorridos nas listas ordenadas (inserirAntena, removerAntena, inserirNefasto)
+    long paresComparados;                       //Pares de antenas com a mesma frequência analisados
+    long bytesLidos;                            //Bytes lidos dos ficheiros de mapas
+    long bytesEscritos;                         //Bytes escritos em ficheiros (mapas e ficheiros binários)
+    long chamadas[NUM_FASES_ESTATISTICA];       //Chamadas concluídas de cada fase
+    double segundos[NUM_FASES_ESTATISTICA];     //Tempo total de cada fase (relógio monotónico)
+}Estatisticas;
+
+/// @brief Declaração da função tempoMonotonico (o mesmo relógio da instrumentação, também usado pelo bench)
+/// @return Devolve o número de segundos desde um instante fixo
+double tempoMonotonico(void);
+
+/// @brief Declaração da função obterEstatisticas
+/// @param e Apontador onde é copiado o estado atual dos contadores (tudo a zero sem EDA_ESTATISTICAS)
+void obterEstatisticas(Estatisticas* e);
+
+/// @brief Declaração da função reiniciarEstatisticas
+void reiniciarEstatisticas(void);
+
+/// @brief Declaração da função mostrarEstatisticas
+/// @param fp Ficheiro de saída (por exemplo stderr)
+void mostrarEstatisticas(FILE* fp);
+
+/// @brief Declaração da função iniciarPool
+/// @param p Apontador para a pool
+/// @param tamanho Tamanho de cada elemento em bytes
+void iniciarPool(Pool* p, size_t tamanho);
+
+/// @brief Declaração da função alocarPool
+/// @param p Apontador para a pool
+/// @return Devolve um elemento por inicializar, ou NULL se não conseguir alocar espaço
+void* alocarPool(Pool* p);
+
+/// @brief Declaração da função devolverPool
+/// @param p Apontador para a pool
+/// @param elemento Elemento entregue por alocarPool, que fica disponível para ser reutilizado
+void devolverPool(Pool* p, void* elemento);
+
+/// @brief Declaração da função destruirPool
+/// @param p Apontador para a pool cujos blocos são todos libertados
+void destruirPool(Pool* p);
 
 /// @brief Declaração da função criarAntena
 /// @param freq Tipo de frequência (Aa até Zz)
@@ -42,7 +191,7 @@ Antena* criarAntena (char freq, int x, int y);
 Antena* inserirAntena(Antena* h, Antena* nova);
 
 /// @brief Declaração da função removerAntena
-/// @param h Apontador para o início da lista de antenas
+/// @param h Apontador para o início de uma lista de antenas criadas com criarAntena (para a lista de um mapa usar removerAntenaMapa)
 /// @param x Coordenada x da antena
 /// @param y Coordenada y da antena
 /// @return Devolve o início da lista depois de remover a antena
@@ -56,25 +205,203 @@ bool gravarFicheiroBinario(char * nomeFicheiro, Antena* h);
 
 /// @brief Declaração da função carregarAntenas
 /// @param nomeficheiro Nome do ficheiro de texto que contém o mapa de antenas
-/// @return Devolve NULL se o arquivo não abrir/se não conseguir alocar espaço
+/// @return Devolve NULL se o arquivo não abrir/se não conseguir alocar espaço (as antenas são criadas com criarAntena e libertadas com free)
 Antena* carregarAntenas(char* nomeFicheiro);
 
+/// @brief Declaração da função criarMapa
+/// @param linhas Número de linhas do mapa
+/// @param colunas Número de colunas do mapa
+/// @return Devolve o novo mapa sem antenas ou NULL se não conseguir alocar espaço
+Mapa* criarMapa(int linhas, int colunas);
+
+/// @brief Declaração da função carregarMapa
+/// @param nomeFicheiro Nome do ficheiro de texto que contém o mapa de antenas
+/// @return Devolve o mapa com as dimensões e as antenas lidas, ou NULL se o ficheiro não abrir/se não conseguir alocar espaço
+Mapa* carregarMapa(char* nomeFicheiro);
+
+/// @brief Declaração da função criarAntenaMapa
+/// @param mapa Apontador para o mapa cuja memória é usada
+/// @param freq Tipo de frequência
+/// @param x Coordenada x da nova antena
+/// @param y Coordenada y da nova antena
+/// @return Devolve a nova antena (para inserir na lista do mapa) ou NULL se não conseguir alocar espaço
+Antena* criarAntenaMapa(Mapa* mapa, char freq, int x, int y);
+
+/// @brief Declaração da função removerAntenaMapa
+/// @param mapa Apontador para o mapa
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @return Devolve false se a antena não existir
+bool removerAntenaMapa(Mapa* mapa, int x, int y);
+
+/// @brief Declaração da função libertarMapa
+/// @param mapa Apontador para o mapa a libertar (incluindo as antenas e os efeitos nefastos criados com a sua memória)
+void libertarMapa(Mapa* mapa);
+
 /// @brief Declaração da função criarNefasto
 /// @param x Coordenada x do novo efeito nefasto
 /// @param y Coordenada y do novo efeito nefasto
 /// @return Devolve o novo efeito nefasto criado
 Nefasto* criarNefasto (int x, int y);
 
+/// @brief Declaração da função criarNefastoMapa
+/// @param mapa Apontador para o mapa cuja memória é usada
+/// @param x Coordenada x do novo efeito nefasto
+/// @param y Coordenada y do novo efeito nefasto
+/// @return Devolve o novo efeito nefasto ou NULL se não conseguir alocar espaço
+Nefasto* criarNefastoMapa(Mapa* mapa, int x, int y);
+
+/// @brief Declaração da função libertarNefasto
+/// @param mapa Apontador para o mapa com cuja memória a lista foi criada (NULL se foi criada com criarNefasto)
+/// @param h Apontador para o início da lista de efeitos nefastos a libertar
+void libertarNefasto(Mapa* mapa, Nefasto* h);
+
 /// @brief Declaração da função inserirNefasto
 /// @param h Apontador para o início da lista de efeitos nefastos
 /// @param novo Apontador para o novo efeito nefasto
 /// @return Devolve a lista atualizada
 Nefasto* inserirNefasto (Nefasto* h, Nefasto* novo);
 
-/// @brief Declaração da função efeitoNefasto
+/// @brief Declaração da função indiceFrequencia
+/// @param freq Frequência da antena
+/// @return Devolve o índice do grupo da frequência (0 até NUM_FREQ-1) ou -1 se a frequência não for válida
+int indiceFrequencia(char freq);
+
+/// @brief Declaração da função adicionarAoGrupo
+/// @param g Apontador para o grupo de frequência
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @return Devolve false se não conseguir alocar espaço
+bool adicionarAoGrupo(GrupoFrequencia* g, int x, int y);
+
+/// @brief Declaração da função agruparFrequencias
 /// @param h Apontador para o início da lista de antenas
-/// @return Devolve uma lista ligada com todas as posições de efeitos nefastos encontradas
-Nefasto* efeitoNefasto (Antena* h);
+/// @param f Apontador para os grupos a preencher
+/// @return Devolve false se não conseguir alocar espaço
+bool agruparFrequencias(Antena* h, Frequencias* f);
+
+/// @brief Declaração da função libertarFrequencias
+/// @param f Apontador para os grupos a libertar
+void libertarFrequencias(Frequencias* f);
+
+/// @brief Declaração da função calcularAntinodos
+/// @param xa Coordenada x da antena de referência
+/// @param ya Coordenada y da antena de referência
+/// @param xs Coordenadas x das antenas parceiras
+/// @param ys Coordenadas y das antenas parceiras
+/// @param n Número de antenas parceiras
+/// @param mapa Apontador para o mapa com os limites
+/// @param rx Vetor onde são escritas as coordenadas x dos pontos (com espaço para 2*n pontos)
+/// @param ry Vetor onde são escritas as coordenadas y dos pontos (com espaço para 2*n pontos)
+/// @return Devolve o número de pontos dentro do mapa escritos em rx/ry
+int calcularAntinodos(int xa, int ya, const int* xs, const int* ys, int n, const Mapa* mapa, int* rx, int* ry);
+
+/// @brief Declaração da função efeitoNefasto
+/// @param mapa Apontador para o mapa com a lista de antenas e os limites
+/// @return Devolve uma lista ligada com todas as posições de efeitos nefastos encontradas (criada com a memória do mapa: libertar com libertarNefasto(mapa, ...), nunca com free)
+Nefasto* efeitoNefasto (Mapa* mapa);
+
+/// @brief Declaração da função criarGrelhaBits
+/// @param linhas Número de linhas do mapa
+/// @param colunas Número de colunas do mapa
+/// @return Devolve a nova grelha com todas as posições desmarcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* criarGrelhaBits(int linhas, int colunas);
+
+/// @brief Declaração da função marcarGrelhaBits
+/// @param g Apontador para a grelha
+/// @param x Coordenada x da posição
+/// @param y Coordenada y da posição
+/// @return Devolve true se a posição ainda não estava marcada
+bool marcarGrelhaBits(GrelhaBits* g, int x, int y);
+
+/// @brief Declaração da função testarGrelhaBits
+/// @param g Apontador para a grelha
+/// @param x Coordenada x da posição
+/// @param y Coordenada y da posição
+/// @return Devolve true se a posição estiver marcada
+bool testarGrelhaBits(GrelhaBits* g, int x, int y);
+
+/// @brief Declaração da função contarGrelhaBits
+/// @param g Apontador para a grelha
+/// @return Devolve o número de posições diferentes marcadas
+long contarGrelhaBits(GrelhaBits* g);
+
+/// @brief Declaração da função grelhaParaNefasto
+/// @param mapa Apontador para o mapa cuja memória é usada para a lista (NULL para usar malloc)
+/// @param g Apontador para a grelha
+/// @return Devolve a lista ordenada de efeitos nefastos, sem repetições, com as posições marcadas na grelha
+Nefasto* grelhaParaNefasto(Mapa* mapa, GrelhaBits* g);
+
+/// @brief Declaração da função libertarGrelhaBits
+/// @param g Apontador para a grelha a libertar
+void libertarGrelhaBits(GrelhaBits* g);
+
+/// @brief Declaração da função efeitoNefastoGrelha
+/// @param mapa Apontador para o mapa com a lista de antenas e as dimensões da grelha
+/// @return Devolve uma grelha com as posições de efeito nefasto marcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* efeitoNefastoGrelha(Mapa* mapa);
+
+/// @brief Declaração da função efeitoNefastoParalelo
+/// @param mapa Apontador para o mapa com a lista de antenas e as dimensões da grelha
+/// @param numThreads Número de threads (0 ou negativo para usar todos os processadores)
+/// @return Devolve uma grelha com as posições de efeito nefasto marcadas ou NULL se não conseguir alocar espaço
+GrelhaBits* efeitoNefastoParalelo(Mapa* mapa, int numThreads);
+
+/// @brief Declaração da função efeitoNefastoHarmonicos
+/// @param mapa Apontador para o mapa com a lista de antenas e as dimensões da grelha
+/// @param numThreads Número de threads (0 ou negativo para usar todos os processadores, 1 para não criar threads)
+/// @return Devolve uma grelha com todas as posições alinhadas com duas antenas da mesma frequência marcadas, ou NULL se não conseguir alocar espaço
+GrelhaBits* efeitoNefastoHarmonicos(Mapa* mapa, int numThreads);
+
+/// @brief Declaração da função criarEstadoNefasto
+/// @param mapa Apontador para o mapa a acompanhar
+/// @return Devolve o estado com os efeitos nefastos das antenas atuais do mapa, ou NULL se não conseguir alocar espaço
+EstadoNefasto* criarEstadoNefasto(Mapa* mapa);
+
+/// @brief Declaração da função inserirAntenaEstado
+/// @param e Apontador para o estado
+/// @param freq Frequência da nova antena
+/// @param x Coordenada x da nova antena
+/// @param y Coordenada y da nova antena
+/// @return Devolve false se a frequência não for válida, se a posição estiver fora do mapa ou ocupada, ou se não conseguir alocar espaço
+bool inserirAntenaEstado(EstadoNefasto* e, char freq, int x, int y);
+
+/// @brief Declaração da função removerAntenaEstado
+/// @param e Apontador para o estado
+/// @param x Coordenada x da antena a remover
+/// @param y Coordenada y da antena a remover
+/// @return Devolve false se a antena não existir (os dados de outra antena podem passar para o nó da antena removida)
+bool removerAntenaEstado(EstadoNefasto* e, int x, int y);
+
+/// @brief Declaração da função contarNefastosEstado
+/// @param e Apontador para o estado
+/// @return Devolve o número de posições diferentes com efeito nefasto
+long contarNefastosEstado(EstadoNefasto* e);
+
+/// @brief Declaração da função nefastoEstado
+/// @param e Apontador para o estado
+/// @param x Coordenada x da posição
+/// @param y Coordenada y da posição
+/// @return Devolve true se a posição tiver efeito nefasto
+bool nefastoEstado(EstadoNefasto* e, int x, int y);
+
+/// @brief Declaração da função avaliarCandidatos
+/// @param e Apontador para o estado (não é alterado)
+/// @param candidatos Vetor com as posições candidatas
+/// @param n Número de candidatas
+/// @param resultado Vetor com n posições onde é escrito, para cada candidata, o número de novas posições com efeito nefasto (-1 se a frequência não for válida ou se a posição estiver fora do mapa ou ocupada)
+/// @param numThreads Número de threads (0 ou negativo para usar todos os processadores, 1 para não criar threads)
+/// @return Devolve false se os parâmetros não forem válidos ou se não conseguir alocar espaço
+bool avaliarCandidatos(EstadoNefasto* e, const CandidatoAntena* candidatos, int n, long* resultado, int numThreads);
+
+/// @brief Declaração da função nefastosDoEstado
+/// @param e Apontador para o estado
+/// @return Devolve a lista ordenada, sem repetições, das posições com efeito nefasto (criada com a memória do mapa: libertar com libertarNefasto(e->mapa, ...))
+Nefasto* nefastosDoEstado(EstadoNefasto* e);
+
+/// @brief Declaração da função libertarEstadoNefasto
+/// @param e Apontador para o estado a libertar (o mapa não é libertado)
+void libertarEstadoNefasto(EstadoNefasto* e);
 
 /// @brief Declaração da função imprimirAntenas
 /// @param h Apontador para o início da lista de antenas
@@ -84,10 +411,67 @@ bool imprimirAntenas(Antena* h);
 /// @param h Apontador para o início da lista de efeitos nefastos
 bool imprimirNefasto(Nefasto* h);
 
+/// @brief Declaração da função escreverAntenasNefasto
+/// @param fp Ficheiro de saída (por exemplo stdout)
+/// @param mapa Apontador para o mapa com as dimensões e a lista de antenas
+/// @param h Apontador para o início da lista de efeitos nefastos (pode ser NULL)
+/// @param g Apontador para a grelha de efeitos nefastos (pode ser NULL)
+bool escreverAntenasNefasto(FILE* fp, Mapa* mapa, Nefasto* h, GrelhaBits* g);
+
 /// @brief Declaração da função imprimirAntenasNefasto
-/// @param nomeFicheiro Nome do ficheiro que contém o mapa das antenas
+/// @param mapa Apontador para o mapa com as dimensões e a lista de antenas
 /// @param h Apontador para o início da lista de efeitos nefastos
-bool imprimirAntenasNefasto(char* nomeFicheiro, Nefasto* h);
+bool imprimirAntenasNefasto(Mapa* mapa, Nefasto* h);
+
+/// @brief Declaração da função processarMapaEmBandas
+/// @param nomeEntrada Nome do ficheiro de texto com o mapa
+/// @param nomeSaida Nome do ficheiro onde é escrito o mapa com os efeitos nefastos (#), ou NULL para só contar
+/// @param linhasPorBanda Número de linhas de cada banda (0 ou negativo para escolher pelo tamanho das linhas)
+/// @return Devolve o número de posições diferentes com efeito nefasto, ou -1 se um ficheiro não abrir ou não conseguir alocar espaço
+long processarMapaEmBandas(char* nomeEntrada, char* nomeSaida, int linhasPorBanda);
+
+/// @brief Declaração da função carregarTabelaAntenas
+/// @param nomeFicheiro Nome do ficheiro de texto com o mapa
+/// @return Devolve a tabela ordenada com as antenas do mapa, ou NULL se o ficheiro não abrir ou não conseguir alocar espaço
+TabelaAntenas* carregarTabelaAntenas(char* nomeFicheiro);
+
+/// @brief Declaração da função criarTabelaAntenas
+/// @param h Apontador para o início da lista de antenas (em qualquer ordem)
+/// @return Devolve a tabela ordenada com as antenas da lista, ou NULL se não conseguir alocar espaço
+TabelaAntenas* criarTabelaAntenas(Antena* h);
+
+/// @brief Declaração da função ordenarTabelaAntenas
+/// @param t Apontador para a tabela (os vetores podem estar em qualquer ordem)
+/// @return Devolve false se não conseguir alocar espaço (a tabela fica como estava)
+bool ordenarTabelaAntenas(TabelaAntenas* t);
+
+/// @brief Declaração da função grupoTabelaAntenas
+/// @param t Apontador para a tabela
+/// @param freq Frequência pedida
+/// @param inicio Apontador onde é devolvida a posição da primeira antena do grupo
+/// @return Devolve o número de antenas com a frequência (0 se a frequência não for válida)
+int grupoTabelaAntenas(const TabelaAntenas* t, char freq, int* inicio);
+
+/// @brief Declaração da função procurarAntenaTabela
+/// @param t Apontador para a tabela
+/// @param freq Frequência da antena
+/// @param x Coordenada x da antena
+/// @param y Coordenada y da antena
+/// @return Devolve a posição da antena na tabela, ou -1 se não existir
+int procurarAntenaTabela(const TabelaAntenas* t, char freq, int x, int y);
+
+/// @brief Declaração da função intervaloLinhasTabela
+/// @param t Apontador para a tabela
+/// @param freq Frequência das antenas
+/// @param x1 Primeira linha do intervalo
+/// @param x2 Última linha do intervalo
+/// @param inicio Apontador onde é devolvida a posição da primeira antena do intervalo
+/// @return Devolve o número de antenas com a frequência e x1 <= x <= x2 (ocupam posições seguidas a partir de *inicio)
+int intervaloLinhasTabela(const TabelaAntenas* t, char freq, int x1, int x2, int* inicio);
+
+/// @brief Declaração da função libertarTabelaAntenas
+/// @param t Apontador para a tabela a libertar
+void libertarTabelaAntenas(TabelaAntenas* t);
 
 
 #endif
\ No newline at end of file
@@ -14,7 +14,7 @@
 int main () {
    Antena* lista = NULL;
    Nefasto* listaEfeitoNefasto = NULL;
-   Antena* nova;
+   Mapa* mapa = NULL;
    bool r;
 
    //Teste de criar/inserir antenas numa lista ligada, remoção de uma antena e imprimir antenas de uma lista ligada em forma tabular
@@ -50,11 +50,11 @@ int main () {
 
    //Teste de carregar um ficheiro txt, detetar efeito nefasto, e imprimir o conteúdo do ficheiro com os efeitos nefastos (#) adicionados
    printf("\n");
-   lista = carregarAntenas("antenas.txt");
-   listaEfeitoNefasto = efeitoNefasto(lista);
+   mapa = carregarMapa("antenas.txt");
+   listaEfeitoNefasto = efeitoNefasto(mapa);
 
-   if (imprimirAntenasNefasto("antenas.txt", listaEfeitoNefasto)){
-      printf("\nMapa atualizado com efeito nefasto.\n");
+   if (imprimirAntenasNefasto(mapa, listaEfeitoNefasto)){
+      printf("Mapa atualizado com efeito nefasto.\n");
    } else {
       printf ("Lista do mapa atualizado com efeitos nefasto não existe.\n");
    }
@@ -68,6 +68,86 @@ int main () {
       printf ("Lista de efeitos nefasto não existe.\n");
    }
 
+   //Teste da grelha de bits: cada posição com efeito nefasto só é contada uma vez
+   GrelhaBits* grelha = efeitoNefastoGrelha(mapa);
+   if (grelha != NULL) {
+      printf("\nPosições diferentes com efeito nefasto: %ld\n", contarGrelhaBits(grelha));
+      libertarGrelhaBits(grelha);
+   }
+
+   //Teste do cálculo paralelo (0 threads = uma por processador)
+   grelha = efeitoNefastoParalelo(mapa, 0);
+   if (grelha != NULL) {
+      printf("Posições diferentes com efeito nefasto (cálculo paralelo): %ld\n", contarGrelhaBits(grelha));
+      libertarGrelhaBits(grelha);
+   }
+
+   //Teste do cálculo por bandas: o mapa é lido do ficheiro 4 linhas de cada vez, sem criar listas
+   printf("Posições diferentes com efeito nefasto (cálculo por bandas): %ld\n", processarMapaEmBandas("antenas.txt", NULL, 4));
+
+   //Teste do modo de harmónicos: todas as posições alinhadas com duas antenas da mesma frequência
+   grelha = efeitoNefastoHarmonicos(mapa, 0);
+   if (grelha != NULL) {
+      printf("Posições diferentes com efeito nefasto (harmónicos): %ld\n", contarGrelhaBits(grelha));
+      libertarGrelhaBits(grelha);
+   }
+
+   //Teste dos harmónicos com antenas fora do mapa: a reta de (9,1000) e (-30,1000) não passa pelo mapa 10x10 (0 posições),
+   //mas a de (-1,-1) e (10,10) atravessa-o na diagonal (10 posições)
+   Mapa* fora = criarMapa(10, 10);
+   if (fora != NULL) {
+      int pares[2][4] = { { 9, 1000, -30, 1000 }, { -1, -1, 10, 10 } };
+      for (int i = 0; i < 2; i++) {
+         fora->antenas = NULL;
+         fora->antenas = inserirAntena(fora->antenas, criarAntenaMapa(fora, 'A', pares[i][0], pares[i][1]));
+         fora->antenas = inserirAntena(fora->antenas, criarAntenaMapa(fora, 'A', pares[i][2], pares[i][3]));
+         grelha = efeitoNefastoHarmonicos(fora, 1);
+         if (grelha != NULL) {
+            printf("Harmónicos das antenas A em (%d,%d) e (%d,%d), fora do mapa 10x10: %ld posições\n",
+                   pares[i][0], pares[i][1], pares[i][2], pares[i][3], contarGrelhaBits(grelha));
+            libertarGrelhaBits(grelha);
+         }
+      }
+      libertarMapa(fora);
+   }
+
+   //Teste do estado incremental: só os pares da antena inserida/removida são recalculados
+   EstadoNefasto* estado = criarEstadoNefasto(mapa);
+   if (estado != NULL) {
+      inserirAntenaEstado(estado, 'A', 2, 2);
+      printf("Depois de inserir a antena A em (2,2): %ld posições com efeito nefasto\n", contarNefastosEstado(estado));
+      removerAntenaEstado(estado, 2, 2);
+      printf("Depois de remover a antena em (2,2): %ld posições com efeito nefasto\n", contarNefastosEstado(estado));
+
+      //Teste da avaliação de candidatas: o estado não é alterado
+      CandidatoAntena candidatos[3] = { { 'A', 2, 2 }, { 'O', 0, 0 }, { 'A', 11, 0 } };
+      long novas[3];
+      if (avaliarCandidatos(estado, candidatos, 3, novas, 0)) {
+         for (int i = 0; i < 3; i++) {
+            printf("Candidata %c em (%d,%d): %ld novas posições com efeito nefasto\n", candidatos[i].freq,
+                   candidatos[i].x, candidatos[i].y, novas[i]);
+         }
+      }
+      libertarEstadoNefasto(estado);
+   }
+
+   //Teste da tabela de antenas: vetores contíguos ordenados por (frequência, x, y)
+   TabelaAntenas* tabela = carregarTabelaAntenas("antenas.txt");
+   if (tabela != NULL) {
+      int inicio, n = intervaloLinhasTabela(tabela, 'O', 2, 3, &inicio);
+      printf("Tabela de antenas: %d antenas, %d com frequência O nas linhas 2 a 3", tabela->n, n);
+      if (n > 0) {
+         printf(" (a primeira em (%d,%d))", tabela->x[inicio], tabela->y[inicio]);
+      }
+      printf("\n");
+      libertarTabelaAntenas(tabela);
+   }
+
+   //Estatísticas da memória do mapa: os nós vêm de blocos contíguos e são libertados de uma só vez
+   printf("Memória do mapa: %ld antenas e %ld efeitos nefastos em %d blocos\n", mapa->poolAntenas.emUso,
+          mapa->poolNefastos.emUso, mapa->poolAntenas.numBlocos + mapa->poolNefastos.numBlocos);
+   libertarMapa(mapa);
+
 
    //if (gravarFicheiroBinario("listaAntenas", lista)) {
    //   printf ("Ficheiro guardado em binário.\n");
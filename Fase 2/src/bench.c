@@ -0,0 +1,348 @@
+/**
+ * @file bench.c
+ * @author Edgar Casal ()
+ * @version 0.1
+ * @date 2025-05-12
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Medição dos tempos das operações do grafo sobre mapas gerados aleatoriamente.
+ * Uso: ./bench [tamanho] [densidade] [desvio] [repeticoes] [semente]
+ *  - tamanho: linhas e colunas do mapa (sem este argumento é medida uma série de 64 até 1024)
+ *  - densidade: fração das posições com antena (por omissão 0.01)
+ *  - desvio: 0 = todas as frequências igualmente prováveis; perto de 1 = quase todas as antenas
+ *    com a primeira frequência (cada frequência tem (1 - desvio) vezes a probabilidade da anterior)
+ *  - repeticoes: número de medições de cada operação (por omissão 3)
+ * O resultado é escrito em CSV no stdout, uma linha por operação e tamanho.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "funcoes.h"
+
+#define MAPA_BENCH "bench_mapa.txt"
+#define BINARIO_BENCH "bench_grafo.bin"
+#define COMPRIMIDO_BENCH "bench_grafo_comprimido.bin"
+#define NUM_FREQ_BENCH 62               // Frequências usadas nos mapas gerados (A-Z, a-z, 0-9)
+#define LIMITE_ARESTAS 20000000L        // Acima deste número de arestas, os cliques não são criados com arestas guardadas
+
+/// @brief Parâmetros de um mapa gerado
+typedef struct ConfigBench {
+    int linhas, colunas;
+    double densidade;
+    double desvio;
+    int repeticoes;
+    long antenas;               // Número de antenas do mapa gerado
+} ConfigBench;
+
+/// @brief Gerador pseudo-aleatório xorshift64*, para os mapas serem iguais em todas as máquinas
+/// @param estado Estado do gerador (diferente de zero)
+/// @return Número entre 0 e 1
+static double aleatorio(uint64_t* estado) {
+    *estado ^= *estado >> 12;
+    *estado ^= *estado << 25;
+    *estado ^= *estado >> 27;
+    return (double)((*estado * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+/// @brief Gera um mapa aleatório e grava-o num ficheiro de texto
+/// @param nomeFicheiro Nome do ficheiro a criar
+/// @param c Parâmetros do mapa (o número de antenas é guardado em c->antenas)
+/// @param semente Estado do gerador pseudo-aleatório
+/// @return true se conseguiu, false se o ficheiro não abrir ou falhar a alocação
+static bool gerarMapa(const char* nomeFicheiro, ConfigBench* c, uint64_t* semente) {
+    const char* frequencias = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    double acumulado[NUM_FREQ_BENCH], peso = 1.0, total = 0.0, r;
+    FILE* fp;
+    char* linha;
+    int k;
+
+    // Probabilidade acumulada de cada frequência, decrescendo em progressão geométrica
+    for (k = 0; k < NUM_FREQ_BENCH; k++) {
+        total += peso;
+        acumulado[k] = total;
+        peso *= 1.0 - c->desvio;
+    }
+
+    fp = fopen(nomeFicheiro, "w");
+    linha = (char*)malloc((size_t)c->colunas + 1);
+    if (fp == NULL || linha == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        free(linha);
+        return false;
+    }
+
+    c->antenas = 0;
+    for (int x = 0; x < c->linhas; x++) {
+        for (int y = 0; y < c->colunas; y++) {
+            linha[y] = '.';
+            if (aleatorio(semente) < c->densidade) {
+                r = aleatorio(semente) * total;
+                for (k = 0; k < NUM_FREQ_BENCH - 1 && acumulado[k] < r; k++);
+                linha[y] = frequencias[k];
+                c->antenas++;
+            }
+        }
+        linha[c->colunas] = '\n';
+        fwrite(linha, 1, (size_t)c->colunas + 1, fp);
+    }
+
+    free(linha);
+    fclose(fp);
+    return true;
+}
+
+/// @brief Escreve uma linha do CSV com o melhor tempo e o tempo médio das repetições de uma operação
+/// @param c Parâmetros do mapa
+/// @param operacao Nome da operação medida
+/// @param tempos Tempo de cada repetição, em segundos
+/// @param resultado Valor devolvido pela operação (para confirmar que todas as versões calculam o mesmo)
+static void registar(const ConfigBench* c, const char* operacao, const double* tempos, long resultado) {
+    double melhor = tempos[0], soma = 0.0;
+
+    for (int i = 0; i < c->repeticoes; i++) {
+        soma += tempos[i];
+        if (tempos[i] < melhor) {
+            melhor = tempos[i];
+        }
+    }
+    printf("2,%s,%d,%d,%ld,%.4f,%.2f,%d,%.6f,%.6f,%ld\n", operacao, c->linhas, c->colunas, c->antenas,
+           c->densidade, c->desvio, c->repeticoes, melhor, soma / c->repeticoes, resultado);
+    fflush(stdout);
+}
+
+/// @brief Devolve o tamanho de um ficheiro
+/// @param nomeFicheiro Nome do ficheiro
+/// @return Número de bytes, ou -1 se o ficheiro não abrir
+static long tamanhoFicheiro(const char* nomeFicheiro) {
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    long n;
+
+    if (fp == NULL) {
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    n = ftell(fp);
+    fclose(fp);
+    return n;
+}
+
+/// @brief Número de arestas que os cliques das frequências terão quando forem guardados
+/// @param g Apontador para o grafo
+/// @return Soma de n * (n - 1) para todas as frequências
+static long arestasDosCliques(Grafo* g) {
+    long total = 0;
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        total += (long)g->membros[f].n * (g->membros[f].n - 1);
+    }
+    return total;
+}
+
+/// @brief Mede todas as operações sobre o mapa gravado em MAPA_BENCH
+/// @param c Parâmetros do mapa
+/// @param tempos Vetor com c->repeticoes posições para os tempos
+static void medirOperacoes(const ConfigBench* c, double* tempos) {
+    Grafo* g;
+    Grafo* lido;
+    GrafoCSR* csr;
+    GrafoMapeado* mapeado;
+    Vertice* destino;
+    bool implicito, res;
+    long resultado = 0;
+    double inicio;
+    int i;
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        g = criarGrafoDeFicheiro(MAPA_BENCH);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = (g != NULL) ? g->numVertices : -1;
+        libertarGrafo(g);
+    }
+    registar(c, "criarGrafoDeFicheiro", tempos, resultado);
+
+    // Criação das adjacências: cada repetição parte de um grafo sem arestas
+    g = criarGrafoDeFicheiro(MAPA_BENCH);
+    if (g == NULL || g->h == NULL) {
+        libertarGrafo(g);
+        return;
+    }
+    implicito = arestasDosCliques(g) > LIMITE_ARESTAS;
+    if (!implicito) {
+        for (i = 0; i < c->repeticoes; i++) {
+            libertarGrafo(g);
+            g = criarGrafoDeFicheiro(MAPA_BENCH);
+            if (g == NULL) {
+                return;
+            }
+            inicio = tempoMonotonico();
+            res = ligarFrequenciasGrafo(g, false);
+            tempos[i] = tempoMonotonico() - inicio;
+            resultado = res ? arestasDosCliques(g) : -1;
+        }
+        registar(c, "ligarFrequenciasGrafo", tempos, resultado);
+    }
+
+    // Com demasiadas arestas, o resto das operações usa os cliques implícitos
+    for (i = 0; i < c->repeticoes; i++) {
+        Grafo* aux = criarGrafoDeFicheiro(MAPA_BENCH);
+        inicio = tempoMonotonico();
+        res = ligarFrequenciasGrafo(aux, true);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = res;
+        libertarGrafo(aux);
+    }
+    registar(c, "ligarFrequenciasGrafoImplicito", tempos, resultado);
+    if (implicito) {
+        ligarFrequenciasGrafo(g, true);
+    }
+
+    // O percurso original usa o campo visitado, reiniciado fora da medição
+    if (!implicito) {
+        for (i = 0; i < c->repeticoes; i++) {
+            resetVisitado(g->h);
+            inicio = tempoMonotonico();
+            resultado = depthFirstTraversal(g->h);
+            tempos[i] = tempoMonotonico() - inicio;
+        }
+        registar(c, "depthFirstTraversal", tempos, resultado);
+    }
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        resultado = depthFirstTraversalGrafo(g, g->h, NULL);
+        tempos[i] = tempoMonotonico() - inicio;
+    }
+    registar(c, "depthFirstTraversalGrafo", tempos, resultado);
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        resultado = percursoLargura(g, g->h, NULL, NULL, NULL, NULL);
+        tempos[i] = tempoMonotonico() - inicio;
+    }
+    registar(c, "percursoLargura", tempos, resultado);
+
+    // O destino é a última antena com a frequência da origem, para existir caminho
+    destino = g->membros[(unsigned char)g->h->freq].v[g->membros[(unsigned char)g->h->freq].n - 1];
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        resultado = (long)caminhoMaisCurto(g, g->h, destino, NULL, 0, NULL);
+        tempos[i] = tempoMonotonico() - inicio;
+    }
+    registar(c, "caminhoMaisCurto", tempos, resultado);
+
+    for (i = 0; i < c->repeticoes; i++) {
+        inicio = tempoMonotonico();
+        csr = congelarGrafo(g);
+        tempos[i] = tempoMonotonico() - inicio;
+        resultado = (csr != NULL) ? csr->numArestas : -1;
+        libertarGrafoCSR(csr);
+    }
+    registar(c, "congelarGrafo", tempos, resultado);
+
+    if (!implicito) {
+        for (i = 0; i < c->repeticoes; i++) {
+            inicio = tempoMonotonico();
+            res = gravarFicheiroBinario(BINARIO_BENCH, g);
+            tempos[i] = tempoMonotonico() - inicio;
+            resultado = res ? tamanhoFicheiro(BINARIO_BENCH) : -1;
+        }
+        registar(c, "gravarFicheiroBinario", tempos, resultado);
+
+        for (i = 0; i < c->repeticoes; i++) {
+            inicio = tempoMonotonico();
+            lido = lerFicheiroBinario(BINARIO_BENCH, &res);
+            tempos[i] = tempoMonotonico() - inicio;
+            resultado = (lido != NULL && res) ? lido->numVertices : -1;
+            libertarGrafo(lido);
+        }
+        registar(c, "lerFicheiroBinario", tempos, resultado);
+
+        // Abertura sem leitura (só o cabeçalho) e com a verificação completa do ficheiro
+        for (int verificar = 0; verificar <= 1; verificar++) {
+            for (i = 0; i < c->repeticoes; i++) {
+                inicio = tempoMonotonico();
+                mapeado = abrirGrafoMapeado(BINARIO_BENCH, verificar);
+                tempos[i] = tempoMonotonico() - inicio;
+                resultado = (mapeado != NULL) ? mapeado->csr.numVertices : -1;
+                fecharGrafoMapeado(mapeado);
+            }
+            registar(c, verificar ? "abrirGrafoMapeadoVerificado" : "abrirGrafoMapeado", tempos, resultado);
+        }
+        remove(BINARIO_BENCH);
+
+        // Formato comprimido (o resultado das gravações é o tamanho do ficheiro, para comparar os dois formatos)
+        for (i = 0; i < c->repeticoes; i++) {
+            inicio = tempoMonotonico();
+            res = gravarFicheiroBinarioComprimido(COMPRIMIDO_BENCH, g);
+            tempos[i] = tempoMonotonico() - inicio;
+            resultado = res ? tamanhoFicheiro(COMPRIMIDO_BENCH) : -1;
+        }
+        registar(c, "gravarFicheiroBinarioComprimido", tempos, resultado);
+
+        for (i = 0; i < c->repeticoes; i++) {
+            inicio = tempoMonotonico();
+            csr = lerFicheiroBinarioCSR(COMPRIMIDO_BENCH, &res);
+            tempos[i] = tempoMonotonico() - inicio;
+            resultado = (csr != NULL && res) ? csr->numArestas : -1;
+            libertarGrafoCSR(csr);
+        }
+        registar(c, "lerFicheiroBinarioComprimidoCSR", tempos, resultado);
+        remove(COMPRIMIDO_BENCH);
+    }
+
+    libertarGrafo(g);
+}
+
+int main(int argc, char* argv[]) {
+    ConfigBench c;
+    uint64_t semente;
+    double* tempos;
+    int tamanho, primeiro, ultimo;
+
+    tamanho = (argc > 1) ? atoi(argv[1]) : 0;
+    c.densidade = (argc > 2) ? atof(argv[2]) : 0.01;
+    c.desvio = (argc > 3) ? atof(argv[3]) : 0.0;
+    c.repeticoes = (argc > 4) ? atoi(argv[4]) : 3;
+    semente = (argc > 5) ? (uint64_t)strtoull(argv[5], NULL, 10) : 12345;
+    if (semente == 0) {
+        semente = 1;
+    }
+    if (c.repeticoes < 1) {
+        c.repeticoes = 1;
+    }
+    if (c.desvio < 0.0 || c.desvio >= 1.0) {
+        c.desvio = 0.0;
+    }
+
+    // Sem tamanho, mede uma série de mapas que duplicam de lado, para mostrar como cada operação escala
+    primeiro = (tamanho > 0) ? tamanho : 64;
+    ultimo = (tamanho > 0) ? tamanho : 1024;
+
+    tempos = (double*)malloc((size_t)c.repeticoes * sizeof(double));
+    if (tempos == NULL) {
+        return 1;
+    }
+
+    printf("fase,operacao,linhas,colunas,antenas,densidade,desvio,repeticoes,melhor_s,media_s,resultado\n");
+    for (int lado = primeiro; lado <= ultimo; lado *= 2) {
+        c.linhas = lado;
+        c.colunas = lado;
+        if (!gerarMapa(MAPA_BENCH, &c, &semente)) {
+            fprintf(stderr, "Erro ao gerar o mapa %dx%d\n", lado, lado);
+            free(tempos);
+            return 1;
+        }
+        medirOperacoes(&c, tempos);
+    }
+
+    // Com a instrumentação ativa (make bench ESTATISTICAS=1), os contadores de toda a execução vão para o stderr
+    mostrarEstatisticas(stderr);
+
+    remove(MAPA_BENCH);
+    free(tempos);
+    return 0;
+}
@@ -10,6 +10,197 @@
 
 #include "funcoes.h"
 #include "malloc.h"
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#pragma region Funções de Estatísticas
+
+/*
+* Instrumentação: com EDA_ESTATISTICAS definido (make ESTATISTICAS=1) as funções principais contam alocações,
+* passos nas listas, arestas criadas e bytes lidos/escritos, e medem o tempo de cada fase.
+* Sem EDA_ESTATISTICAS as macros não geram código nenhum.
+*/
+/// @brief Devolve o instante atual de um relógio que nunca anda para trás
+/// @return Número de segundos desde um instante fixo
+double tempoMonotonico(void) {
+    struct timespec t;
+#ifdef _WIN32
+    timespec_get(&t, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &t);
+#endif
+    return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+#ifdef EDA_ESTATISTICAS
+static Estatisticas estatisticas;
+
+#define CONTAR(campo, n) (estatisticas.campo += (long)(n))
+#define INICIAR_TEMPO(inicio) double inicio = tempoMonotonico()
+#define TERMINAR_TEMPO(inicio, fase) registarTempo((fase), (inicio))
+
+/// @brief Soma ao tempo de uma fase o tempo passado desde o início da chamada
+/// @param fase Fase medida
+/// @param inicio Instante em que a chamada começou
+static void registarTempo(FaseEstatistica fase, double inicio) {
+    estatisticas.segundos[fase] += tempoMonotonico() - inicio;
+    estatisticas.chamadas[fase]++;
+}
+#else
+#define CONTAR(campo, n) ((void)0)
+#define INICIAR_TEMPO(inicio) ((void)0)
+#define TERMINAR_TEMPO(inicio, fase) ((void)0)
+#endif
+
+/// @brief Copia o estado atual dos contadores da instrumentação
+/// @param e Apontador onde é copiado o estado (tudo a zero sem EDA_ESTATISTICAS)
+void obterEstatisticas(Estatisticas* e) {
+    if (e == NULL) {
+        return;
+    }
+#ifdef EDA_ESTATISTICAS
+    *e = estatisticas;
+#else
+    memset(e, 0, sizeof(*e));
+#endif
+}
+
+/// @brief Põe todos os contadores e tempos da instrumentação a zero
+void reiniciarEstatisticas(void) {
+#ifdef EDA_ESTATISTICAS
+    memset(&estatisticas, 0, sizeof(estatisticas));
+#endif
+}
+
+/// @brief Escreve os contadores e os tempos de cada fase, um valor por linha no formato "nome: valor"
+/// @param fp Ficheiro de saída (por exemplo stderr)
+void mostrarEstatisticas(FILE* fp) {
+    if (fp == NULL) {
+        return;
+    }
+#ifdef EDA_ESTATISTICAS
+    static const char* nomes[NUM_FASES_ESTATISTICA] = { "carregar", "adjacencias", "percursos", "caminhos", "congelar", "gravar", "ler" };
+    Estatisticas e;
+
+    obterEstatisticas(&e);
+    fprintf(fp, "alocacoes: %ld\npassosLista: %ld\narestasCriadas: %ld\nbytesLidos: %ld\nbytesEscritos: %ld\n",
+            e.alocacoes, e.passosLista, e.arestasCriadas, e.bytesLidos, e.bytesEscritos);
+    for (int i = 0; i < NUM_FASES_ESTATISTICA; i++) {
+        fprintf(fp, "fase.%s: %ld chamadas, %.6f s\n", nomes[i], e.chamadas[i], e.segundos[i]);
+    }
+#else
+    fprintf(fp, "estatisticas: desativadas (compilar com -DEDA_ESTATISTICAS)\n");
+#endif
+}
+
+#pragma endregion
+
+#pragma region Funções de Memória
+
+#define POOL_BLOCO_INICIAL 64           // Elementos do primeiro bloco de uma pool
+#define POOL_BLOCO_MAXIMO 65536         // Os blocos duplicam de tamanho até este número de elementos
+#define POOL_CABECALHO ((sizeof(BlocoPool) + 15) & ~(size_t)15)    // Cabeçalho do bloco, alinhado a 16 bytes
+
+/// @brief Prepara uma pool vazia (nenhum bloco é alocado até ao primeiro pedido)
+/// @param p Apontador para a pool
+/// @param tamanho Tamanho de cada elemento em bytes
+void iniciarPool(Pool* p, size_t tamanho) {
+    // Cada elemento tem de conseguir guardar o apontador da lista de livres e manter o alinhamento dos seguintes
+    if (tamanho < sizeof(void*)) {
+        tamanho = sizeof(void*);
+    }
+    p->tamanho = (tamanho + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    p->porBloco = POOL_BLOCO_INICIAL;
+    p->blocos = NULL;
+    p->proximo = NULL;
+    p->restantes = 0;
+    p->livres = NULL;
+    p->emUso = 0;
+    p->pedidos = 0;
+    p->reutilizados = 0;
+    p->numBlocos = 0;
+    p->bytes = 0;
+}
+
+/// @brief Entrega um elemento da pool: primeiro da lista de livres, depois do bloco atual, alocando um bloco novo se preciso
+/// @param p Apontador para a pool
+/// @return Apontador para o elemento (sem inicializar), ou NULL se falhar a alocação
+void* alocarPool(Pool* p) {
+    void* elemento;
+
+    p->pedidos++;
+    CONTAR(alocacoes, 1);
+
+    // Reutiliza um elemento devolvido
+    if (p->livres != NULL) {
+        elemento = p->livres;
+        p->livres = *(void**)elemento;
+        p->reutilizados++;
+        p->emUso++;
+        return elemento;
+    }
+
+    // O bloco atual acabou: aloca outro, com o dobro dos elementos do anterior
+    if (p->restantes == 0) {
+        size_t bytes = POOL_CABECALHO + (size_t)p->porBloco * p->tamanho;
+        BlocoPool* bloco = (BlocoPool*)malloc(bytes);
+        if (bloco == NULL) {
+            return NULL;
+        }
+        bloco->prox = p->blocos;
+        p->blocos = bloco;
+        p->proximo = (char*)bloco + POOL_CABECALHO;
+        p->restantes = p->porBloco;
+        p->numBlocos++;
+        p->bytes += bytes;
+        if (p->porBloco < POOL_BLOCO_MAXIMO) {
+            p->porBloco *= 2;
+        }
+    }
+
+    elemento = p->proximo;
+    p->proximo += p->tamanho;
+    p->restantes--;
+    p->emUso++;
+    return elemento;
+}
+
+/// @brief Devolve um elemento à pool, para ser reutilizado (fica no início da lista de livres)
+/// @param p Apontador para a pool
+/// @param elemento Elemento entregue antes por alocarPool (pode ser NULL)
+void devolverPool(Pool* p, void* elemento) {
+    if (elemento != NULL) {
+        *(void**)elemento = p->livres;
+        p->livres = elemento;
+        p->emUso--;
+    }
+}
+
+/// @brief Liberta todos os blocos da pool de uma só vez, em O(número de blocos)
+/// @param p Apontador para a pool
+void destruirPool(Pool* p) {
+    BlocoPool* bloco;
+
+    while (p->blocos != NULL) {
+        bloco = p->blocos;
+        p->blocos = bloco->prox;
+        free(bloco);
+    }
+    iniciarPool(p, p->tamanho);
+}
+
+#pragma endregion
 
 #pragma region Funções de Antenas
 /// @brief Cria uma nova antena com os dados fornecidos
@@ -22,6 +213,7 @@ Vertice* criarAntena(char freq, int x, int y){
 
     // Aloca memória para a nova antena 
     nova = (Vertice*)malloc(sizeof(Vertice));
+    CONTAR(alocacoes, 1);
 
     //Verifica se o espaço foi alocado corretamente
     if (!nova) {
@@ -34,8 +226,11 @@ Vertice* criarAntena(char freq, int x, int y){
     nova->y = y;
     // Inicializa os ponteiros da lista ligada e adjacências como NULL
     nova->prox= NULL;
+    nova->ant= NULL;
     nova->adj= NULL;
     nova->visitado=0;
+    nova->id=-1;
+    nova->posMembros=-1;
 
     // Devolve a antena criada
     return nova;
@@ -63,6 +258,7 @@ Vertice* inserirAntena(Vertice* h, Vertice* nova) {
     // Percorre a lista até encontrar a posição correta para inserir a nova antena
     while (aux->prox != NULL && (aux->prox->x < nova->x || (aux->prox->x == nova->x && aux->prox->y < nova->y))) {
         aux = aux -> prox;
+        CONTAR(passosLista, 1);
     }
     // Insere a nova antena entre aux e aux->prox
     nova->prox = aux->prox;
@@ -104,6 +300,7 @@ Vertice* removerAntena(Vertice* h, int x, int y, bool *res) {
     while (aux != NULL && (aux->x != x || aux->y != y)) {
         aux2 = aux;
         aux= aux->prox;
+        CONTAR(passosLista, 1);
     }
 
     // Se não encontrou a antena, não faz nada
@@ -156,6 +353,7 @@ Vertice* procurarAntena(Vertice* h, char freq, int x, int y) {
         }
 
         h= h->prox;
+        CONTAR(passosLista, 1);
     }
     // Se não for encontrada nenhuma antena com os dados indicados devolve NULL
     return NULL;
@@ -185,6 +383,51 @@ bool resetVisitado(Vertice* h) {
 #pragma endregion
 
 #pragma region Funções de Adjacencia
+/// @brief Raiz quadrada inteira (arredondada para baixo), sem depender da biblioteca matemática
+/// @param n Valor
+/// @return Maior r tal que r*r <= n
+static uint64_t raizInteira(uint64_t n) {
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+
+    // Método dos dígitos binários: decide um bit do resultado de cada vez
+    while (bit > n) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (n >= r + bit) {
+            n -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+/// @brief Calcula o peso de uma ligação: a distância entre as coordenadas das duas antenas
+/// @param metrica Métrica a usar
+/// @param a Primeira antena
+/// @param b Segunda antena
+/// @return Distância de Manhattan, ou distância euclidiana arredondada para cima
+int calcularPeso(MetricaDistancia metrica, Vertice* a, Vertice* b) {
+    int64_t dx = (int64_t)a->x - b->x;
+    int64_t dy = (int64_t)a->y - b->y;
+    uint64_t quadrado, r;
+
+    if (dx < 0) dx = -dx;
+    if (dy < 0) dy = -dy;
+
+    if (metrica == DISTANCIA_EUCLIDIANA) {
+        // Arredonda para cima, para o peso nunca ser menor que a distância real
+        quadrado = (uint64_t)(dx * dx) + (uint64_t)(dy * dy);
+        r = raizInteira(quadrado);
+        return (int)(r * r == quadrado ? r : r + 1);
+    }
+    return (int)(dx + dy);
+}
+
 /// @brief Cria uma nova adjacência (ligação) entre dois vértices com a mesma frequência
 /// @param origem Vértice de onde parte a ligação
 /// @param destino Vértice para onde a ligação aponta
@@ -200,6 +443,7 @@ Aresta* criarAdjacencia(Vertice* origem, Vertice* destino) {
 
     // Aloca memória para a nova aresta (ligação)
     novaAdjacencia = (Aresta*)malloc(sizeof(Aresta));
+    CONTAR(alocacoes, 1);
 
     // Verifica se a alocação foi bem-sucedida
     if (novaAdjacencia == NULL) {
@@ -207,8 +451,9 @@ Aresta* criarAdjacencia(Vertice* origem, Vertice* destino) {
     }
 
     novaAdjacencia->destino = destino;              // Define o destino desta ligação
-    novaAdjacencia->peso = 0;                       // Atribui o peso da ligação (ainda não atribuído)
+    novaAdjacencia->peso = calcularPeso(DISTANCIA_MANHATTAN, origem, destino);   // O peso é a distância entre as antenas
     novaAdjacencia->prox = NULL;                    // Como esta aresta ainda não está ligada a outras, o próximo é NULL
+    CONTAR(arestasCriadas, 1);
 
     // Devolve a nova aresta criada 
     return novaAdjacencia;
@@ -277,204 +522,3169 @@ int contarAdjacencias(Vertice* v) {
 }
 #pragma endregion
 
-#pragma region Funções de Ficheiros
-/// @brief Realiza um percurso em profundidade (DFS) a partir de uma antena
-/// @param origem Vértice de início do percurso
-/// @return true se o percurso foi feito, false se a origem for inválida
-bool depthFirstTraversal(Vertice* origem) {
-    Aresta* aux;
+#pragma region Funções do Índice Espacial
 
-    // Verifica se o vértice de origem é válido
-    if (origem == NULL) {
+#define ESPACIAL_LADO_OMISSAO 16            // Lado das células quando não é indicado
+#define ESPACIAL_CAPACIDADE_INICIAL 64
+
+/// @brief Divide uma coordenada pelo lado da célula, arredondando para baixo (também para coordenadas negativas)
+/// @param c Coordenada
+/// @param lado Lado da célula
+/// @return Coordenada da célula
+static int celulaDe(int c, int lado) {
+    return (c >= 0) ? c / lado : -((-(c + 1)) / lado) - 1;
+}
+
+/// @brief Parte do índice a que pertence uma frequência
+/// @param freq Frequência (0 para todas)
+/// @return 0 para todas as frequências, 1 + freq para uma só
+static int parteDe(char freq) {
+    return (freq == 0) ? 0 : 1 + (unsigned char)freq;
+}
+
+/// @brief Calcula a posição inicial de uma célula na tabela
+/// @param parte Parte do índice
+/// @param cx Coordenada X da célula
+/// @param cy Coordenada Y da célula
+/// @param mascara Capacidade da tabela menos 1
+/// @return Posição na tabela
+static int posicaoCelula(int parte, int cx, int cy, int mascara) {
+    uint64_t k = ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+
+    k ^= (uint64_t)parte * 0xC2B2AE3D27D4EB4FULL;
+    k *= 0x9E3779B97F4A7C15ULL;
+    k ^= k >> 29;
+    return (int)(k & (uint64_t)mascara);
+}
+
+/// @brief Procura uma célula na tabela
+/// @param e Apontador para o índice
+/// @param parte Parte do índice
+/// @param cx Coordenada X da célula
+/// @param cy Coordenada Y da célula
+/// @return Apontador para a célula, ou NULL se não existir
+static CelulaEspacial* procurarCelula(IndiceEspacial* e, int parte, int cx, int cy) {
+    int mascara = e->capacidade - 1;
+    int i = posicaoCelula(parte, cx, cy, mascara);
+
+    while (e->celulas[i].usada) {
+        if (e->celulas[i].parte == parte && e->celulas[i].cx == cx && e->celulas[i].cy == cy) {
+            return &e->celulas[i];
+        }
+        i = (i + 1) & mascara;
+    }
+    return NULL;
+}
+
+/// @brief Reconstrói a tabela de células com uma nova capacidade (as células mantêm os seus vetores)
+/// @param e Apontador para o índice
+/// @param capacidade Nova capacidade (potência de 2)
+/// @return true se conseguiu, false se falhar a alocação
+static bool redimensionarEspacial(IndiceEspacial* e, int capacidade) {
+    CelulaEspacial* antigas = e->celulas;
+    CelulaEspacial* novas = (CelulaEspacial*)calloc((size_t)capacidade, sizeof(CelulaEspacial));
+    int mascara = capacidade - 1, j;
+
+    if (novas == NULL) {
         return false;
     }
+    for (int i = 0; i < e->capacidade; i++) {
+        if (antigas[i].usada) {
+            j = posicaoCelula(antigas[i].parte, antigas[i].cx, antigas[i].cy, mascara);
+            while (novas[j].usada) {
+                j = (j + 1) & mascara;
+            }
+            novas[j] = antigas[i];
+        }
+    }
+    free(antigas);
+    e->celulas = novas;
+    e->capacidade = capacidade;
+    return true;
+}
 
-    // Marca o vértice atual como visitado
-    origem->visitado = 1;
+/// @brief Coloca um vértice na célula certa de uma parte, criando a célula se ainda não existir
+/// @param e Apontador para o índice
+/// @param parte Parte do índice
+/// @param v Vértice a colocar
+/// @return true se conseguiu, false se falhar a alocação
+static bool colocarNaCelula(IndiceEspacial* e, int parte, Vertice* v) {
+    int cx = celulaDe(v->x, e->lado), cy = celulaDe(v->y, e->lado);
+    CelulaEspacial* c = procurarCelula(e, parte, cx, cy);
+    int mascara, i;
+
+    if (c == NULL) {
+        // Mantém a tabela abaixo de metade da ocupação
+        if ((e->ocupadas + 1) * 2 > e->capacidade && !redimensionarEspacial(e, e->capacidade * 2)) {
+            return false;
+        }
+        mascara = e->capacidade - 1;
+        i = posicaoCelula(parte, cx, cy, mascara);
+        while (e->celulas[i].usada) {
+            i = (i + 1) & mascara;
+        }
+        c = &e->celulas[i];
+        c->usada = true;
+        c->parte = parte;
+        c->cx = cx;
+        c->cy = cy;
+        e->ocupadas++;
+        if (e->ocupadas == 1) {
+            e->minCx = e->maxCx = cx;
+            e->minCy = e->maxCy = cy;
+        }
+        if (cx < e->minCx) e->minCx = cx;
+        if (cx > e->maxCx) e->maxCx = cx;
+        if (cy < e->minCy) e->minCy = cy;
+        if (cy > e->maxCy) e->maxCy = cy;
+    }
 
-    // Percorre todas as adjacências (arestas) da antena atual
-    aux = origem->adj;
-    while (aux != NULL) {
-        // Se o vértice de destino ainda não foi visitado, chama recursivamente
-        if (aux->destino->visitado == 0) {
-            aux->destino->visitado=1;
-            depthFirstTraversal(aux->destino);
+    if (c->n == c->capacidade) {
+        int capacidade = (c->capacidade == 0) ? 4 : c->capacidade * 2;
+        Vertice** aux = (Vertice**)realloc(c->v, (size_t)capacidade * sizeof(Vertice*));
+        if (aux == NULL) {
+            return false;
         }
-        // Avança para a próxima adjacência
-        aux = aux->prox;
+        c->v = aux;
+        c->capacidade = capacidade;
     }
+    c->v[c->n++] = v;
     return true;
 }
 
-/* /// @brief 
-/// @param origem 
-/// @return 
-bool breadthFirstTraversal(Vertice* origem) {
-    Aresta* aux;
+/// @brief Tira um vértice da sua célula de uma parte (trocando-o com o último da célula)
+/// @param e Apontador para o índice
+/// @param parte Parte do índice
+/// @param v Vértice a tirar
+static void tirarDaCelula(IndiceEspacial* e, int parte, Vertice* v) {
+    CelulaEspacial* c = procurarCelula(e, parte, celulaDe(v->x, e->lado), celulaDe(v->y, e->lado));
 
-    if (origem == NULL) {
+    if (c == NULL) {
+        return;
+    }
+    for (int i = 0; i < c->n; i++) {
+        if (c->v[i] == v) {
+            c->v[i] = c->v[--c->n];
+            return;
+        }
+    }
+}
+
+/// @brief Coloca um vértice no índice (na parte de todas as frequências e na parte da sua frequência)
+/// @param e Apontador para o índice
+/// @param v Vértice a colocar
+/// @return true se conseguiu, false se falhar a alocação
+static bool adicionarEspacial(IndiceEspacial* e, Vertice* v) {
+    return colocarNaCelula(e, 0, v) && colocarNaCelula(e, parteDe(v->freq), v);
+}
+
+/// @brief Liberta a memória de um índice espacial
+/// @param e Apontador para o índice (pode ser NULL)
+static void libertarIndiceEspacial(IndiceEspacial* e) {
+    if (e != NULL) {
+        for (int i = 0; i < e->capacidade; i++) {
+            free(e->celulas[i].v);
+        }
+        free(e->celulas);
+        free(e);
+    }
+}
+
+/// @brief Cria o índice espacial com todos os vértices do grafo
+/// @param g Apontador para o grafo
+/// @param lado Lado das células
+/// @return Apontador para o índice, ou NULL se falhar a alocação
+static IndiceEspacial* construirIndiceEspacial(Grafo* g, int lado) {
+    IndiceEspacial* e = (IndiceEspacial*)malloc(sizeof(IndiceEspacial));
+    bool ok;
+
+    if (e == NULL) {
+        return NULL;
+    }
+    e->lado = lado;
+    e->capacidade = ESPACIAL_CAPACIDADE_INICIAL;
+    e->ocupadas = 0;
+    e->minCx = e->maxCx = e->minCy = e->maxCy = 0;
+    e->valido = true;
+    e->celulas = (CelulaEspacial*)calloc(ESPACIAL_CAPACIDADE_INICIAL, sizeof(CelulaEspacial));
+    ok = (e->celulas != NULL);
+
+    for (Vertice* v = g->h; ok && v != NULL; v = v->prox) {
+        ok = adicionarEspacial(e, v);
+    }
+    if (!ok) {
+        libertarIndiceEspacial(e);
+        return NULL;
+    }
+    return e;
+}
+
+/// @brief Devolve o índice espacial do grafo pronto a consultar, criando-o ou reconstruindo-o se preciso
+/// @param g Apontador para o grafo
+/// @return Apontador para o índice, ou NULL se falhar a alocação
+static IndiceEspacial* indiceEspacialDe(Grafo* g) {
+    if (g->espacial == NULL || !g->espacial->valido) {
+        if (!ativarIndiceEspacial(g, g->espacial != NULL ? g->espacial->lado : 0)) {
+            return NULL;
+        }
+    }
+    return g->espacial;
+}
+
+/// @brief Cria (ou recria) o índice espacial do grafo; a partir daí é mantido a cada inserção e remoção
+/// @param g Apontador para o grafo
+/// @param lado Lado de cada célula da grelha (0 ou negativo para o valor por omissão)
+/// @return true se conseguiu, false se falhar a alocação
+bool ativarIndiceEspacial(Grafo* g, int lado) {
+    IndiceEspacial* e;
+
+    if (g == NULL) {
         return false;
     }
 
-    aux = origem->adj;
-    if (aux != NULL) {
-        aux->destino->visitado = 0;
-        aux = aux->prox;
+    e = construirIndiceEspacial(g, lado > 0 ? lado : ESPACIAL_LADO_OMISSAO);
+    if (e == NULL) {
+        return false;
     }
+    libertarIndiceEspacial(g->espacial);
+    g->espacial = e;
+    return true;
+}
 
-} */
+/// @brief Liberta o índice espacial do grafo (as inserções e remoções deixam de o manter)
+/// @param g Apontador para o grafo
+void desativarIndiceEspacial(Grafo* g) {
+    if (g != NULL) {
+        libertarIndiceEspacial(g->espacial);
+        g->espacial = NULL;
+    }
+}
 
-/// @brief Cria um grafo (lista ligada de antenas) a partir de um ficheiro de texto com o mapa da cidade
-/// @param nomeFicheiro Nome do ficheiro de entrada com o mapa
-/// @return Apontador para o grafo criado, ou NULL em caso de erro
-Grafo* criarGrafoDeFicheiro(char* nomeFicheiro) {
-    char c;
-    int x = 0, y = 0;
-    Vertice* novaAntena;
-    Grafo* g;
+/// @brief Distância euclidiana ao quadrado entre um ponto e uma antena
+/// @param x Coordenada X do ponto
+/// @param y Coordenada Y do ponto
+/// @param v Antena
+/// @return (dx² + dy²)
+static int64_t distanciaQuadrado(int x, int y, Vertice* v) {
+    int64_t dx = (int64_t)v->x - x, dy = (int64_t)v->y - y;
+    return dx * dx + dy * dy;
+}
 
-    // Aloca memória para o grafo
-    g = (Grafo*)malloc(sizeof(Grafo));
-    if (!g) return NULL;
+/// @brief Zona de uma consulta: retângulo e, opcionalmente, círculo
+typedef struct ZonaEspacial {
+    int x1, y1, x2, y2;         //Retângulo (limites incluídos)
+    bool circulo;               //Se true, só conta as antenas dentro do círculo
+    int cx, cy;                 //Centro do círculo
+    int64_t raio2;              //Raio do círculo ao quadrado
+} ZonaEspacial;
+
+/// @brief Junta ao resultado as antenas de uma célula que estão dentro da zona
+/// @param c Célula
+/// @param z Zona da consulta
+/// @param resultado Vetor para as antenas (pode ser NULL)
+/// @param max Número máximo de antenas a escrever
+/// @param total Número de antenas encontradas até agora (atualizado)
+static void recolherCelula(CelulaEspacial* c, const ZonaEspacial* z, Vertice** resultado, int max, int* total) {
+    Vertice* v;
+
+    for (int j = 0; j < c->n; j++) {
+        v = c->v[j];
+        if (v->x < z->x1 || v->x > z->x2 || v->y < z->y1 || v->y > z->y2) {
+            continue;
+        }
+        if (z->circulo && distanciaQuadrado(z->cx, z->cy, v) > z->raio2) {
+            continue;
+        }
+        if (resultado != NULL && *total < max) {
+            resultado[*total] = v;
+        }
+        (*total)++;
+    }
+}
 
-    g->h = NULL;           // Inicializa a lista ligada de vértices
-    g->numVertices = 0;    // Começa com zero antenas
+/// @brief Procura as antenas de uma parte do índice dentro de uma zona
+/// @param e Apontador para o índice
+/// @param parte Parte do índice
+/// @param z Zona da consulta
+/// @param resultado Vetor para as antenas (pode ser NULL)
+/// @param max Número máximo de antenas a escrever
+/// @return Número total de antenas encontradas
+static int consultarZona(IndiceEspacial* e, int parte, const ZonaEspacial* z, Vertice** resultado, int max) {
+    int c1 = celulaDe(z->x1, e->lado), c2 = celulaDe(z->x2, e->lado);
+    int d1 = celulaDe(z->y1, e->lado), d2 = celulaDe(z->y2, e->lado);
+    int total = 0;
+    CelulaEspacial* c;
+
+    // Só interessam as células dentro dos limites das células existentes
+    if (c1 < e->minCx) c1 = e->minCx;
+    if (c2 > e->maxCx) c2 = e->maxCx;
+    if (d1 < e->minCy) d1 = e->minCy;
+    if (d2 > e->maxCy) d2 = e->maxCy;
+    if (e->ocupadas == 0 || c1 > c2 || d1 > d2) {
+        return 0;
+    }
 
-    FILE* fp = fopen(nomeFicheiro, "r");  // Abre o ficheiro em modo leitura
-    if (fp == NULL) {
-        return NULL;
+    if ((int64_t)(c2 - c1 + 1) * (d2 - d1 + 1) > (int64_t)e->ocupadas) {
+        // O retângulo cobre mais células do que as que existem: é mais rápido percorrer a tabela
+        for (int i = 0; i < e->capacidade; i++) {
+            c = &e->celulas[i];
+            if (c->usada && c->parte == parte && c->cx >= c1 && c->cx <= c2 && c->cy >= d1 && c->cy <= d2) {
+                recolherCelula(c, z, resultado, max, &total);
+            }
+        }
+    } else {
+        for (int cx = c1; cx <= c2; cx++) {
+            for (int cy = d1; cy <= d2; cy++) {
+                c = procurarCelula(e, parte, cx, cy);
+                if (c != NULL) {
+                    recolherCelula(c, z, resultado, max, &total);
+                }
+            }
+        }
     }
+    return total;
+}
 
-    // Percorre cada caractere do ficheiro
-    while ((c = fgetc(fp)) != EOF) {
-        if (c == '\n') {
-            x++;       // Avança uma linha (vertical)
-            y=0;     // Reinicia a coluna
-        } else {
-            if (c != '.') {
-                // Cria uma nova antena se o caractere for uma letra (A-Z ou a-z)
-                novaAntena = criarAntena(c, x, y);
-
-                if (novaAntena) {
-                    // Insere a antena na lista de forma ordenada
-                    g->h = inserirAntena(g->h, novaAntena);
-                    g->numVertices++;
+/// @brief Procura as antenas dentro de um retângulo (limites incluídos)
+/// @param g Apontador para o grafo
+/// @param x1 Coordenada X de um canto
+/// @param y1 Coordenada Y de um canto
+/// @param x2 Coordenada X do canto oposto
+/// @param y2 Coordenada Y do canto oposto
+/// @param freq Frequência das antenas a procurar (0 para todas)
+/// @param resultado Vetor onde são escritas as antenas encontradas (pode ser NULL)
+/// @param max Número máximo de antenas a escrever em resultado
+/// @return Número total de antenas no retângulo, ou -1 se falhar a alocação
+int antenasNoRetangulo(Grafo* g, int x1, int y1, int x2, int y2, char freq, Vertice** resultado, int max) {
+    IndiceEspacial* e;
+    ZonaEspacial z;
+
+    if (g == NULL || (e = indiceEspacialDe(g)) == NULL) {
+        return -1;
+    }
+
+    z.x1 = (x1 < x2) ? x1 : x2;
+    z.x2 = (x1 < x2) ? x2 : x1;
+    z.y1 = (y1 < y2) ? y1 : y2;
+    z.y2 = (y1 < y2) ? y2 : y1;
+    z.circulo = false;
+    z.cx = z.cy = 0;
+    z.raio2 = 0;
+    return consultarZona(e, parteDe(freq), &z, resultado, max);
+}
+
+/// @brief Procura as antenas a uma distância euclidiana de (x, y) não superior a raio
+/// @param g Apontador para o grafo
+/// @param x Coordenada X do centro
+/// @param y Coordenada Y do centro
+/// @param raio Raio da procura
+/// @param freq Frequência das antenas a procurar (0 para todas)
+/// @param resultado Vetor onde são escritas as antenas encontradas (pode ser NULL)
+/// @param max Número máximo de antenas a escrever em resultado
+/// @return Número total de antenas no círculo, ou -1 se falhar a alocação
+int antenasNoRaio(Grafo* g, int x, int y, int raio, char freq, Vertice** resultado, int max) {
+    IndiceEspacial* e;
+    ZonaEspacial z;
+
+    if (g == NULL || raio < 0 || (e = indiceEspacialDe(g)) == NULL) {
+        return -1;
+    }
+
+    z.x1 = (x > INT_MIN + raio) ? x - raio : INT_MIN;
+    z.x2 = (x < INT_MAX - raio) ? x + raio : INT_MAX;
+    z.y1 = (y > INT_MIN + raio) ? y - raio : INT_MIN;
+    z.y2 = (y < INT_MAX - raio) ? y + raio : INT_MAX;
+    z.circulo = true;
+    z.cx = x;
+    z.cy = y;
+    z.raio2 = (int64_t)raio * raio;
+    return consultarZona(e, parteDe(freq), &z, resultado, max);
+}
+
+/// @brief Compara duas antenas pela distância a um ponto, desempatando pelas coordenadas
+/// @param da Distância² da primeira antena
+/// @param a Primeira antena
+/// @param db Distância² da segunda antena
+/// @param b Segunda antena
+/// @return true se a primeira antena vem antes da segunda
+static bool antesDe(int64_t da, Vertice* a, int64_t db, Vertice* b) {
+    if (da != db) return da < db;
+    if (a->x != b->x) return a->x < b->x;
+    return a->y < b->y;
+}
+
+/// @brief Junta as antenas de uma célula às k melhores, mantidas por ordem crescente de distância
+/// @param c Célula
+/// @param x Coordenada X do ponto
+/// @param y Coordenada Y do ponto
+/// @param k Número de antenas pretendidas
+/// @param melhores Vetor das melhores antenas
+/// @param distancias Distâncias² das melhores antenas
+/// @param n Número de antenas em melhores (atualizado)
+static void juntarMaisProximas(CelulaEspacial* c, int x, int y, int k, Vertice** melhores, int64_t* distancias, int* n) {
+    for (int j = 0; j < c->n; j++) {
+        Vertice* v = c->v[j];
+        int64_t d = distanciaQuadrado(x, y, v);
+        int i;
+
+        if (*n == k && !antesDe(d, v, distancias[k - 1], melhores[k - 1])) {
+            continue;
+        }
+        // Inserção ordenada, descartando a pior se o vetor já estiver cheio
+        i = (*n < k) ? (*n)++ : k - 1;
+        while (i > 0 && antesDe(d, v, distancias[i - 1], melhores[i - 1])) {
+            melhores[i] = melhores[i - 1];
+            distancias[i] = distancias[i - 1];
+            i--;
+        }
+        melhores[i] = v;
+        distancias[i] = d;
+    }
+}
+
+/// @brief Procura as k antenas mais próximas de (x, y) (distância euclidiana; empates desfeitos pelas coordenadas)
+/// @param g Apontador para o grafo
+/// @param x Coordenada X do ponto
+/// @param y Coordenada Y do ponto
+/// @param k Número de antenas a procurar
+/// @param freq Frequência das antenas a procurar (0 para todas)
+/// @param resultado Vetor com k posições onde são escritas as antenas, da mais próxima para a mais afastada
+/// @return Número de antenas escritas (menos de k se não houver antenas suficientes), ou -1 se falhar a alocação
+int antenasMaisProximas(Grafo* g, int x, int y, int k, char freq, Vertice** resultado) {
+    IndiceEspacial* e;
+    int64_t* distancias;
+    int parte, ox, oy, n = 0;
+    CelulaEspacial* c;
+
+    if (g == NULL || resultado == NULL || (e = indiceEspacialDe(g)) == NULL) {
+        return -1;
+    }
+    if (k <= 0 || e->ocupadas == 0) {
+        return 0;
+    }
+
+    distancias = (int64_t*)malloc((size_t)k * sizeof(int64_t));
+    if (distancias == NULL) {
+        return -1;
+    }
+    parte = parteDe(freq);
+    ox = celulaDe(x, e->lado);
+    oy = celulaDe(y, e->lado);
+
+    // Percorre anéis de células cada vez mais afastados da célula do ponto
+    for (int64_t r = 0; ; r++) {
+        // Qualquer antena num anel r está a pelo menos (r - 1) * lado do ponto
+        int64_t minimo = (r - 1) * (int64_t)e->lado;
+        bool cobreTudo = ox - r <= e->minCx && ox + r >= e->maxCx && oy - r <= e->minCy && oy + r >= e->maxCy;
+
+        if (n == k && r > 0 && minimo * minimo > distancias[k - 1]) {
+            break;
+        }
+
+        if (8 * r > (int64_t)e->ocupadas) {
+            // O anel tem mais células do que as que existem: acaba com uma passagem por toda a tabela
+            n = 0;
+            for (int i = 0; i < e->capacidade; i++) {
+                c = &e->celulas[i];
+                if (c->usada && c->parte == parte) {
+                    juntarMaisProximas(c, x, y, k, resultado, distancias, &n);
+                }
+            }
+            break;
+        }
+
+        for (int64_t cx = ox - r; cx <= ox + r; cx++) {
+            // Nas colunas interiores do anel só interessam a primeira e a última linha
+            int64_t passo = (cx == ox - r || cx == ox + r || r == 0) ? 1 : 2 * r;
+            for (int64_t cy = oy - r; cy <= oy + r; cy += passo) {
+                if (cx < e->minCx || cx > e->maxCx || cy < e->minCy || cy > e->maxCy) {
+                    continue;
+                }
+                c = procurarCelula(e, parte, (int)cx, (int)cy);
+                if (c != NULL) {
+                    juntarMaisProximas(c, x, y, k, resultado, distancias, &n);
                 }
             }
-            y++;  // Avança uma coluna (horizontal)
+        }
+
+        if (cobreTudo) {
+            break;
         }
     }
 
-    fclose(fp);  // Fecha o ficheiro
+    free(distancias);
+    return n;
+}
+
+#pragma endregion
 
-    // Retorna o grafo criado com a lista de antenas
-    return g;
+#pragma region Funções do Grafo
+
+#define INDICE_CAPACIDADE_INICIAL 64
+
+// Marca usada nas entradas do índice cujo vértice foi removido (a procura tem de continuar depois delas)
+static Vertice marcaApagada;
+#define ENTRADA_APAGADA (&marcaApagada)
+
+/// @brief Calcula a posição inicial de (x, y) no índice
+/// @param x Coordenada X
+/// @param y Coordenada Y
+/// @param mascara Capacidade do índice menos 1
+/// @return Posição no vetor de entradas
+static int posicaoIndice(int x, int y, int mascara) {
+    uint64_t k = ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+
+    // Mistura os bits das duas coordenadas para espalhar posições vizinhas pela tabela
+    k *= 0x9E3779B97F4A7C15ULL;
+    k ^= k >> 29;
+    return (int)(k & (uint64_t)mascara);
 }
 
-/// @brief Grava a lista de antenas e respetivas adjacências num ficheiro binário.
-///        Para cada antena, são gravados a frequência e as coordenadas, seguidos
-///        dos dados das antenas adjacentes (frequência e coordenadas).
-/// @param h Apontador para o início da lista de antenas (vértices).
-/// @return true se a gravação for bem-sucedida, false em caso de erro.
-bool gravarFicheiroBinario (Vertice* h) {  
-    Vertice* listaVertices = h;
-    Aresta* adj;
+/// @brief Procura a entrada do índice com as coordenadas (x, y)
+/// @param ind Apontador para o índice
+/// @param x Coordenada X
+/// @param y Coordenada Y
+/// @return Apontador para a entrada, ou NULL se as coordenadas não estiverem no índice
+static EntradaIndice* procurarEntrada(IndiceCoordenadas* ind, int x, int y) {
+    int mascara = ind->capacidade - 1;
+    int i = posicaoIndice(x, y, mascara);
+
+    // Sondagem linear: avança até encontrar as coordenadas ou uma entrada livre
+    while (ind->entradas[i].v != NULL) {
+        if (ind->entradas[i].v != ENTRADA_APAGADA && ind->entradas[i].x == x && ind->entradas[i].y == y) {
+            return &ind->entradas[i];
+        }
+        i = (i + 1) & mascara;
+    }
+    return NULL;
+}
 
-    // Abre o ficheiro em modo de escrita binária (cria novo ou substitui)
-    FILE * fp = fopen("grafo.bin", "wb");
+/// @brief Coloca um vértice no índice, sem verificar se já lá está e sem aumentar a tabela
+/// @param ind Apontador para o índice
+/// @param v Vértice a colocar
+static void colocarEntrada(IndiceCoordenadas* ind, Vertice* v) {
+    int mascara = ind->capacidade - 1;
+    int i = posicaoIndice(v->x, v->y, mascara);
 
-    // Verifica se houve falha na abertura do ficheiro
-    if (fp == NULL) {
+    while (ind->entradas[i].v != NULL && ind->entradas[i].v != ENTRADA_APAGADA) {
+        i = (i + 1) & mascara;
+    }
+    if (ind->entradas[i].v == ENTRADA_APAGADA) {
+        ind->apagadas--;
+    }
+    ind->entradas[i].x = v->x;
+    ind->entradas[i].y = v->y;
+    ind->entradas[i].v = v;
+    ind->ocupadas++;
+}
+
+/// @brief Reconstrói o índice com uma nova capacidade, descartando as entradas apagadas
+/// @param ind Apontador para o índice
+/// @param capacidade Nova capacidade (potência de 2)
+/// @return true se conseguiu, false se falhar a alocação
+static bool redimensionarIndice(IndiceCoordenadas* ind, int capacidade) {
+    EntradaIndice* antigas = ind->entradas;
+    int capacidadeAntiga = ind->capacidade;
+
+    ind->entradas = (EntradaIndice*)calloc((size_t)capacidade, sizeof(EntradaIndice));
+    if (ind->entradas == NULL) {
+        ind->entradas = antigas;
         return false;
     }
+    ind->capacidade = capacidade;
+    ind->ocupadas = 0;
+    ind->apagadas = 0;
 
-    // Verifica se a lista está vazia
-    if (h == NULL) {
+    for (int i = 0; i < capacidadeAntiga; i++) {
+        if (antigas[i].v != NULL && antigas[i].v != ENTRADA_APAGADA) {
+            colocarEntrada(ind, antigas[i].v);
+        }
+    }
+    free(antigas);
+    return true;
+}
+
+/// @brief Garante espaço para mais um vértice na lista de membros de uma frequência
+/// @param m Apontador para a lista de membros
+/// @return true se houver espaço, false se falhar a alocação
+static bool reservarMembros(MembrosFrequencia* m) {
+    if (m->n == m->capacidade) {
+        int capacidade = (m->capacidade == 0) ? 8 : m->capacidade * 2;
+        Vertice** v = (Vertice**)realloc(m->v, (size_t)capacidade * sizeof(Vertice*));
+        if (v == NULL) {
+            return false;
+        }
+        m->v = v;
+        m->capacidade = capacidade;
+    }
+    return true;
+}
+
+/// @brief Verifica se um vértice pertence ao grafo
+/// @param g Apontador para o grafo
+/// @param v Vértice
+/// @return true se o vértice for do grafo
+static bool verticeDoGrafo(Grafo* g, Vertice* v) {
+    return v != NULL && v->id >= 0 && v->id < g->numVertices && g->vertices[v->id] == v;
+}
+
+/// @brief Garante espaço na estrutura de componentes para n ids
+/// @param c Apontador para as componentes
+/// @param n Número de ids
+/// @return true se houver espaço, false se falhar a alocação
+static bool reservarComponentes(Componentes* c, int n) {
+    int* aux;
+
+    if (n <= c->capacidade) {
+        return true;
+    }
+
+    // Cada vetor é trocado assim que é realocado, por isso uma falha a meio não deixa apontadores inválidos
+    aux = (int*)realloc(c->pai, (size_t)n * sizeof(int));
+    if (aux == NULL) {
+        return false;
+    }
+    c->pai = aux;
+    aux = (int*)realloc(c->rank, (size_t)n * sizeof(int));
+    if (aux == NULL) {
         return false;
     }
+    c->rank = aux;
+    aux = (int*)realloc(c->tamanho, (size_t)n * sizeof(int));
+    if (aux == NULL) {
+        return false;
+    }
+    c->tamanho = aux;
+    c->capacidade = n;
+    return true;
+}
+
+/// @brief Coloca um id numa componente só sua
+/// @param c Apontador para as componentes
+/// @param id Id do vértice
+static void novaComponente(Componentes* c, int id) {
+    c->pai[id] = id;
+    c->rank[id] = 0;
+    c->tamanho[id] = 1;
+    c->numComponentes++;
+}
+
+/// @brief Encontra o representante (raiz) da componente de um id, encurtando o caminho percorrido
+/// @param c Apontador para as componentes
+/// @param id Id do vértice
+/// @return Id da raiz
+static int raizComponente(Componentes* c, int id) {
+    int raiz = id, proximo;
+
+    while (c->pai[raiz] != raiz) {
+        raiz = c->pai[raiz];
+    }
+
+    // Compressão de caminho: todos os ids do caminho passam a apontar diretamente para a raiz
+    while (c->pai[id] != raiz) {
+        proximo = c->pai[id];
+        c->pai[id] = raiz;
+        id = proximo;
+    }
+    return raiz;
+}
 
-    // Percorre a lista de antenas (vértices)
-    while (listaVertices != NULL) {
-        // Grava os dados da antena atual (frequência e coordenadas)
-        fwrite(&listaVertices->freq, 1, sizeof(char), fp);
-        fwrite(&listaVertices->x, 1, sizeof(int), fp);
-        fwrite(&listaVertices->y, 1, sizeof(int), fp);
+/// @brief Junta as componentes de dois ids, pendurando a árvore de menor rank na de maior
+/// @param c Apontador para as componentes
+/// @param a Id do primeiro vértice
+/// @param b Id do segundo vértice
+static void juntarComponentes(Componentes* c, int a, int b) {
+    a = raizComponente(c, a);
+    b = raizComponente(c, b);
+    if (a == b) {
+        return;
+    }
+    if (c->rank[a] < c->rank[b]) {
+        int aux = a;
+        a = b;
+        b = aux;
+    }
+    c->pai[b] = a;
+    c->tamanho[a] += c->tamanho[b];
+    if (c->rank[a] == c->rank[b]) {
+        c->rank[a]++;
+    }
+    c->numComponentes--;
+}
 
-        // Percorre a lista de adjacências (arestas) da antena atual
-        adj = listaVertices->adj;
+/// @brief Reconstrói as componentes a partir de todas as arestas guardadas e das ligações implícitas
+/// @param g Apontador para o grafo
+/// @return true se as componentes estão atualizadas, false se falhar a alocação
+static bool atualizarComponentes(Grafo* g) {
+    Componentes* c = &g->componentes;
+    MembrosFrequencia* m;
 
-        // Contagem do número de adjacencias antes de percorrer a lista de adjacencias
-        int n = contarAdjacencias(listaVertices);
-        fwrite(&n, 1, sizeof(int), fp);
+    if (c->valido) {
+        return true;
+    }
+    if (!reservarComponentes(c, g->capacidadeVertices)) {
+        return false;
+    }
 
-        while (adj != NULL) {
-            // Grava os dados da antena de destino (adjacente)
-            fwrite(&adj->destino->freq, 1, sizeof(char), fp);
-            fwrite(&adj->destino->x, 1, sizeof(int), fp);
-            fwrite(&adj->destino->y, 1, sizeof(int), fp);
-            // Avança para a próxima aresta
-            adj = adj->prox;
+    c->numComponentes = 0;
+    for (int i = 0; i < g->numVertices; i++) {
+        novaComponente(c, i);
+    }
+    for (int i = 0; i < g->numVertices; i++) {
+        for (Aresta* a = g->vertices[i]->adj; a != NULL; a = a->prox) {
+            juntarComponentes(c, i, a->destino->id);
         }
-        // Avança para o próximo vértice da lista
-        listaVertices = listaVertices->prox;
     }
-    // Fecha o ficheiro e indica sucesso
-    fclose(fp);
+    if (g->cliquesImplicitos) {
+        for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+            m = &g->membros[f];
+            for (int i = 1; i < m->n; i++) {
+                juntarComponentes(c, m->v[0]->id, m->v[i]->id);
+            }
+        }
+    }
+    c->valido = true;
     return true;
 }
 
-/// @brief Lê um ficheiro binário e reconstrói a lista de antenas e respetivas adjacências
-/// @param nomeFicheiro Nome do ficheiro binário a abrir
-/// @param res Apontador para um booleano que indica se a leitura foi bem sucedida
-/// @return Devolve a lista de vértices (antenas) reconstruída, ou NULL em caso de erro
-Vertice* lerFicheiroBinario (char* nomeFicheiro, bool *res) {
-    // Variáveis auxiliares para armazenar temporariamente os dados lidos
-    char freq, fAdj;
-    int x, y, xAdj, yAdj, n;
+/// @brief Cria um grafo vazio, com o índice de coordenadas inicializado
+/// @return Apontador para o novo grafo, ou NULL se falhar a alocação
+Grafo* criarGrafo(void) {
+    Grafo* g = (Grafo*)malloc(sizeof(Grafo));
 
-    // Lista de antenas a ser construída
-    Vertice* lista = NULL;
+    if (g == NULL) {
+        return NULL;
+    }
 
-    // Abre o ficheiro em modo leitura binária
-    FILE* fp = fopen(nomeFicheiro, "rb");
+    g->h = NULL;
+    g->cauda = NULL;
+    g->numVertices = 0;
+    g->vertices = NULL;
+    g->capacidadeVertices = 0;
+    memset(g->membros, 0, sizeof(g->membros));
+    g->cliquesImplicitos = false;
+    iniciarPool(&g->poolVertices, sizeof(Vertice));
+    iniciarPool(&g->poolArestas, sizeof(Aresta));
+    g->metrica = DISTANCIA_MANHATTAN;
+    memset(&g->componentes, 0, sizeof(g->componentes));
+    g->componentes.valido = true;
+    g->espacial = NULL;
+
+    g->indice.capacidade = INDICE_CAPACIDADE_INICIAL;
+    g->indice.ocupadas = 0;
+    g->indice.apagadas = 0;
+    g->indice.entradas = (EntradaIndice*)calloc(INDICE_CAPACIDADE_INICIAL, sizeof(EntradaIndice));
+    if (g->indice.entradas == NULL) {
+        free(g);
+        return NULL;
+    }
+    return g;
+}
 
-    // Se não abrir o ficheiro corretamente devolve null
-    if (fp == NULL) {
-        *res = false;
+/// @brief Cria uma antena e insere-a no grafo, na lista ordenada e no índice de coordenadas
+/// @param g Apontador para o grafo
+/// @param freq Frequência da antena
+/// @param x Coordenada X da antena
+/// @param y Coordenada Y da antena
+/// @return Apontador para o vértice criado, ou NULL se a posição já estiver ocupada ou falhar a alocação
+Vertice* inserirAntenaGrafo(Grafo* g, char freq, int x, int y) {
+    MembrosFrequencia* membros;
+    Vertice* nova;
+    Vertice* aux;
+
+    if (g == NULL) {
         return NULL;
     }
 
-    // Lê os dados enquanto houver informação no ficheiro
-    while (fread(&freq, sizeof(char), 1, fp) == 1 &&
-       fread(&x, sizeof(int), 1, fp) == 1 &&
-       fread(&y, sizeof(int), 1, fp) == 1) {
-
-        // Cria nova antena e insere na lista
-        Vertice* nova = criarAntena(freq, x, y);
-        lista = inserirAntena(lista, nova);
-
-        // Lê o número de adjacências associadas a esta antena
-        fread(&n, sizeof(int), 1, fp); 
-
-        // Lê os dados de cada adjacência e reconstrói as ligações
-        for (int i = 0; i < n; i++) {
-            fread(&fAdj, sizeof(char), 1, fp);
-            fread(&xAdj, sizeof(int), 1, fp);
-            fread(&yAdj, sizeof(int), 1, fp);
-
-            // Procura na lista o vértice de destino com os dados lidos
-            Vertice* destino = procurarAntena(lista, fAdj, xAdj, yAdj);
-            if (destino != NULL) {
-                // Cria a ligação (aresta) e insere-a na lista de adjacências da origem
-                Aresta* novaAdj = criarAdjacencia(nova, destino);
-                inserirAdjacencia(nova, novaAdj);
-            }
+    // Não podem existir duas antenas na mesma posição
+    if (procurarEntrada(&g->indice, x, y) != NULL) {
+        return NULL;
+    }
+
+    // Mantém a ocupação do índice (incluindo as entradas apagadas) abaixo de 70%
+    if ((g->indice.ocupadas + g->indice.apagadas + 1) * 10 > g->indice.capacidade * 7) {
+        int capacidade = g->indice.capacidade;
+        if ((g->indice.ocupadas + 1) * 10 > capacidade * 5) {
+            capacidade *= 2;
+        }
+        if (!redimensionarIndice(&g->indice, capacidade)) {
+            return NULL;
         }
     }
-    // Fecha o ficheiro e atualiza o resultado
-    fclose(fp);
-    *res = true;
-    return lista;
+
+    // Garante espaço na tabela de vértices por id
+    if (g->numVertices == g->capacidadeVertices) {
+        int capacidade = (g->capacidadeVertices == 0) ? 64 : g->capacidadeVertices * 2;
+        Vertice** vertices = (Vertice**)realloc(g->vertices, (size_t)capacidade * sizeof(Vertice*));
+        if (vertices == NULL) {
+            return NULL;
+        }
+        g->vertices = vertices;
+        g->capacidadeVertices = capacidade;
+    }
+    if (!reservarComponentes(&g->componentes, g->capacidadeVertices)) {
+        return NULL;
+    }
+
+    membros = &g->membros[(unsigned char)freq];
+    if (!reservarMembros(membros)) {
+        return NULL;
+    }
+
+    // O vértice vem da memória do grafo, e não de um malloc por antena
+    nova = (Vertice*)alocarPool(&g->poolVertices);
+    if (nova == NULL) {
+        return NULL;
+    }
+    nova->freq = freq;
+    nova->x = x;
+    nova->y = y;
+    nova->prox = NULL;
+    nova->ant = NULL;
+    nova->adj = NULL;
+    nova->visitado = 0;
+
+    if (g->h == NULL) {
+        // Lista vazia
+        g->h = nova;
+        g->cauda = nova;
+    } else if (g->cauda->x < x || (g->cauda->x == x && g->cauda->y < y)) {
+        // Caso habitual ao ler um mapa (por ordem de linhas): a antena vai para o fim, em O(1)
+        nova->ant = g->cauda;
+        g->cauda->prox = nova;
+        g->cauda = nova;
+    } else if (x < g->h->x || (x == g->h->x && y < g->h->y)) {
+        // Antes da primeira antena
+        nova->prox = g->h;
+        g->h->ant = nova;
+        g->h = nova;
+    } else {
+        // Caso geral: procura a antena depois da qual a nova deve ficar
+        aux = g->h;
+        while (aux->prox != NULL && (aux->prox->x < x || (aux->prox->x == x && aux->prox->y < y))) {
+            aux = aux->prox;
+            CONTAR(passosLista, 1);
+        }
+        nova->prox = aux->prox;
+        nova->ant = aux;
+        aux->prox->ant = nova;      // aux não é a cauda (esse caso foi tratado acima)
+        aux->prox = nova;
+    }
+
+    colocarEntrada(&g->indice, nova);
+
+    // O novo vértice fica com o primeiro id livre
+    nova->id = g->numVertices;
+    g->vertices[nova->id] = nova;
+    g->numVertices++;
+
+    // E fica no fim da lista de membros da sua frequência
+    nova->posMembros = membros->n;
+    membros->v[membros->n++] = nova;
+
+    // O novo vértice é uma componente sozinho, a não ser que fique ligado implicitamente à sua frequência
+    if (g->componentes.valido) {
+        novaComponente(&g->componentes, nova->id);
+        if (g->cliquesImplicitos && membros->n > 1) {
+            juntarComponentes(&g->componentes, nova->id, membros->v[0]->id);
+        }
+    }
+
+    // Se o índice espacial estiver ativo, a antena entra na sua célula; se falhar, é reconstruído na próxima consulta
+    if (g->espacial != NULL && g->espacial->valido && !adicionarEspacial(g->espacial, nova)) {
+        g->espacial->valido = false;
+    }
+    return nova;
+}
+
+/// @brief Procura uma antena no grafo através do índice de coordenadas, em O(1) em média
+/// @param g Apontador para o grafo
+/// @param freq Frequência a procurar
+/// @param x Coordenada X
+/// @param y Coordenada Y
+/// @return Apontador para o vértice encontrado ou NULL se não existir
+Vertice* procurarAntenaGrafo(Grafo* g, char freq, int x, int y) {
+    EntradaIndice* e;
+
+    if (g == NULL) {
+        return NULL;
+    }
+
+    e = procurarEntrada(&g->indice, x, y);
+    if (e == NULL || e->v->freq != freq) {
+        return NULL;
+    }
+    return e->v;
+}
+
+/// @brief Remove da lista de adjacências de um vértice a primeira aresta que aponta para o destino dado
+/// @param g Apontador para o grafo (a aresta volta à sua memória)
+/// @param origem Vértice cuja lista de adjacências é alterada
+/// @param destino Vértice de destino da aresta a remover
+/// @return true se a aresta foi encontrada e removida
+static bool removerArestaPara(Grafo* g, Vertice* origem, Vertice* destino) {
+    Aresta* aux = origem->adj;
+    Aresta* anterior = NULL;
+
+    while (aux != NULL && aux->destino != destino) {
+        anterior = aux;
+        aux = aux->prox;
+    }
+    if (aux == NULL) {
+        return false;
+    }
+    if (anterior == NULL) {
+        origem->adj = aux->prox;
+    } else {
+        anterior->prox = aux->prox;
+    }
+    devolverPool(&g->poolArestas, aux);
+    return true;
+}
+
+/// @brief Remove uma antena do grafo, com as suas arestas e as arestas que apontam para ela
+///        (as arestas de entrada são encontradas a partir das arestas de saída, que ligarAntenasGrafo cria aos pares)
+/// @param g Apontador para o grafo
+/// @param x Coordenada X da antena a remover
+/// @param y Coordenada Y da antena a remover
+/// @return true se a antena foi removida, false se não existir
+bool removerAntenaGrafo(Grafo* g, int x, int y) {
+    MembrosFrequencia* membros;
+    EntradaIndice* e;
+    Vertice* v;
+    Aresta* aux;
+
+    if (g == NULL) {
+        return false;
+    }
+
+    // Encontra o vértice em O(1) através do índice
+    e = procurarEntrada(&g->indice, x, y);
+    if (e == NULL) {
+        return false;
+    }
+    v = e->v;
+    e->v = ENTRADA_APAGADA;
+    g->indice.ocupadas--;
+    g->indice.apagadas++;
+
+    // Retira o vértice da lista sem a percorrer, graças ao apontador para o anterior
+    if (v->ant != NULL) {
+        v->ant->prox = v->prox;
+    } else {
+        g->h = v->prox;
+    }
+    if (v->prox != NULL) {
+        v->prox->ant = v->ant;
+    } else {
+        g->cauda = v->ant;
+    }
+
+    // Liberta as arestas de saída e, por cada uma, a aresta de volta correspondente (as arestas são criadas
+    // aos pares por ligarAntenasGrafo, por isso uma aresta repetida tem também a sua própria aresta de volta)
+    while (v->adj != NULL) {
+        aux = v->adj;
+        v->adj = aux->prox;
+        if (aux->destino != v) {
+            removerArestaPara(g, aux->destino, v);
+        }
+        devolverPool(&g->poolArestas, aux);
+    }
+
+    // Uma remoção pode partir uma componente, o que o union-find não desfaz: reconstrói na próxima consulta
+    g->componentes.valido = false;
+
+    // O último vértice passa a usar o id do removido, para os ids continuarem seguidos
+    g->numVertices--;
+    if (v->id != g->numVertices) {
+        g->vertices[v->id] = g->vertices[g->numVertices];
+        g->vertices[v->id]->id = v->id;
+    }
+
+    // O mesmo na lista de membros da frequência: o último membro passa para a posição do removido
+    membros = &g->membros[(unsigned char)v->freq];
+    membros->n--;
+    if (v->posMembros != membros->n) {
+        membros->v[v->posMembros] = membros->v[membros->n];
+        membros->v[v->posMembros]->posMembros = v->posMembros;
+    }
+
+    if (g->espacial != NULL && g->espacial->valido) {
+        tirarDaCelula(g->espacial, 0, v);
+        tirarDaCelula(g->espacial, parteDe(v->freq), v);
+    }
+
+    devolverPool(&g->poolVertices, v);
+    return true;
+}
+
+/// @brief Cria uma aresta com a memória do grafo (as arestas dos vértices de um grafo devem ser criadas assim, e não com criarAdjacencia)
+/// @param g Apontador para o grafo
+/// @param origem Vértice de origem da ligação
+/// @param destino Vértice de destino da ligação
+/// @return Apontador para a nova aresta (ainda por inserir), ou NULL se as frequências forem diferentes ou falhar a alocação
+Aresta* criarAdjacenciaGrafo(Grafo* g, Vertice* origem, Vertice* destino) {
+    Aresta* nova;
+
+    if (g == NULL || origem == NULL || destino == NULL || origem->freq != destino->freq) {
+        return NULL;
+    }
+
+    nova = (Aresta*)alocarPool(&g->poolArestas);
+    if (nova == NULL) {
+        return NULL;
+    }
+    nova->destino = destino;
+    nova->peso = calcularPeso(g->metrica, origem, destino);
+    nova->prox = NULL;
+    CONTAR(arestasCriadas, 1);
+
+    // A aresta vai ligar as componentes dos dois vértices
+    if (g->componentes.valido) {
+        juntarComponentes(&g->componentes, origem->id, destino->id);
+    }
+    return nova;
+}
+
+/// @brief Liga duas antenas do grafo com uma aresta em cada sentido
+/// @param g Apontador para o grafo
+/// @param a Primeira antena
+/// @param b Segunda antena
+/// @return true se as arestas foram criadas, false se as frequências forem diferentes ou falhar a alocação
+bool ligarAntenasGrafo(Grafo* g, Vertice* a, Vertice* b) {
+    Aresta* ab;
+    Aresta* ba;
+
+    if (g == NULL || a == NULL || b == NULL) {
+        return false;
+    }
+
+    ab = criarAdjacenciaGrafo(g, a, b);
+    if (ab == NULL) {
+        return false;
+    }
+    ba = criarAdjacenciaGrafo(g, b, a);
+    if (ba == NULL) {
+        // As componentes já foram juntadas pela primeira aresta, que afinal não fica
+        devolverPool(&g->poolArestas, ab);
+        g->componentes.valido = false;
+        return false;
+    }
+    inserirAdjacencia(a, ab);
+    inserirAdjacencia(b, ba);
+    return true;
+}
+
+/// @brief Muda a métrica do grafo e recalcula o peso de todas as arestas guardadas
+/// @param g Apontador para o grafo
+/// @param metrica Nova métrica
+void definirMetricaGrafo(Grafo* g, MetricaDistancia metrica) {
+    if (g == NULL) {
+        return;
+    }
+
+    g->metrica = metrica;
+    for (Vertice* v = g->h; v != NULL; v = v->prox) {
+        for (Aresta* a = v->adj; a != NULL; a = a->prox) {
+            a->peso = calcularPeso(metrica, v, a->destino);
+        }
+    }
+}
+
+/// @brief Liga todas as antenas com a mesma frequência, usando as listas de membros de cada frequência
+/// @param g Apontador para o grafo
+/// @param implicito Se true, não cria arestas: as ligações passam a ser produzidas pelo iterador de vizinhos (memória O(V));
+///                  se false, cria as arestas nos dois sentidos para cada par (k² arestas por frequência com k antenas)
+/// @return true se conseguiu, false se o grafo for inválido ou falhar a alocação
+bool ligarFrequenciasGrafo(Grafo* g, bool implicito) {
+    MembrosFrequencia* m;
+
+    if (g == NULL) {
+        return false;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    if (implicito) {
+        g->cliquesImplicitos = true;
+        g->componentes.valido = false;
+        TERMINAR_TEMPO(tempoInicio, FASE_ADJACENCIAS);
+        return true;
+    }
+
+    // Só os pares dentro de cada frequência são visitados, em vez de todos os pares de vértices
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        m = &g->membros[f];
+        for (int i = 0; i < m->n; i++) {
+            for (int j = i + 1; j < m->n; j++) {
+                if (!ligarAntenasGrafo(g, m->v[i], m->v[j])) {
+                    return false;
+                }
+            }
+        }
+    }
+    TERMINAR_TEMPO(tempoInicio, FASE_ADJACENCIAS);
+    return true;
+}
+
+/// @brief Prepara um iterador sobre os vizinhos de um vértice
+/// @param g Apontador para o grafo
+/// @param v Vértice cujos vizinhos se querem percorrer
+/// @param it Iterador a preparar
+void iniciarVizinhos(Grafo* g, Vertice* v, IteradorVizinhos* it) {
+    it->g = g;
+    it->v = v;
+    it->aresta = (v != NULL) ? v->adj : NULL;
+    it->pos = 0;
+    it->semMembros = (g == NULL || v == NULL || !g->cliquesImplicitos);
+    it->peso = 0;
+}
+
+/// @brief Devolve o próximo vizinho do iterador (o peso da ligação fica em it->peso): primeiro as arestas guardadas, depois os membros da mesma frequência
+///        (no modo implícito, as arestas guardadas para a mesma frequência são saltadas, para não repetir vizinhos)
+/// @param it Iterador preparado com iniciarVizinhos
+/// @return Próximo vértice vizinho, ou NULL se já não houver mais
+Vertice* proximoVizinho(IteradorVizinhos* it) {
+    Vertice* w;
+    MembrosFrequencia* m;
+
+    while (it->aresta != NULL) {
+        w = it->aresta->destino;
+        it->peso = it->aresta->peso;
+        it->aresta = it->aresta->prox;
+        if (it->semMembros || w->freq != it->v->freq) {
+            return w;
+        }
+    }
+
+    if (it->semMembros) {
+        return NULL;
+    }
+
+    m = &it->g->membros[(unsigned char)it->v->freq];
+    while (it->pos < m->n) {
+        w = m->v[it->pos++];
+        if (w != it->v) {
+            // As ligações implícitas não estão guardadas: o peso é calculado na hora
+            it->peso = calcularPeso(it->g->metrica, it->v, w);
+            return w;
+        }
+    }
+    return NULL;
+}
+
+/// @brief Conta os vizinhos de um vértice, incluindo as ligações implícitas
+/// @param g Apontador para o grafo
+/// @param v Vértice a analisar
+/// @return Número de vizinhos
+int grauGrafo(Grafo* g, Vertice* v) {
+    Aresta* aux;
+    int grau = 0;
+
+    if (v == NULL) {
+        return 0;
+    }
+    if (g == NULL || !g->cliquesImplicitos) {
+        return contarAdjacencias(v);
+    }
+
+    // Modo implícito: todos os outros membros da frequência, mais as arestas guardadas para outras frequências
+    for (aux = v->adj; aux != NULL; aux = aux->prox) {
+        if (aux->destino->freq != v->freq) {
+            grau++;
+        }
+    }
+    return grau + g->membros[(unsigned char)v->freq].n - 1;
+}
+
+/// @brief Liberta toda a memória do grafo (vértices, arestas e índice)
+/// @param g Apontador para o grafo
+void libertarGrafo(Grafo* g) {
+    if (g == NULL) {
+        return;
+    }
+
+    // Os vértices e as arestas estão nas pools do grafo: basta libertar os blocos
+    destruirPool(&g->poolVertices);
+    destruirPool(&g->poolArestas);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        free(g->membros[f].v);
+    }
+    free(g->componentes.pai);
+    free(g->componentes.rank);
+    free(g->componentes.tamanho);
+    libertarIndiceEspacial(g->espacial);
+    free(g->indice.entradas);
+    free(g->vertices);
+    free(g);
+}
+
+#pragma endregion
+
+#pragma region Funções de Componentes
+/// @brief Atribui a cada vértice o número da sua componente ligada, em tempo quase linear (union-find)
+/// @param g Apontador para o grafo
+/// @param rotulo Vetor indexado pelo id (numVertices posições) onde fica o número da componente (0 até ao total - 1); pode ser NULL
+/// @return Número de componentes, ou -1 se falhar a alocação
+int rotularComponentes(Grafo* g, int* rotulo) {
+    Componentes* c;
+    int total = 0, raiz;
+
+    if (g == NULL || !atualizarComponentes(g)) {
+        return -1;
+    }
+    c = &g->componentes;
+
+    if (rotulo != NULL) {
+        // As componentes são numeradas pela ordem em que aparecem os seus vértices (por id)
+        for (int i = 0; i < g->numVertices; i++) {
+            rotulo[i] = -1;
+        }
+        for (int i = 0; i < g->numVertices; i++) {
+            raiz = raizComponente(c, i);
+            if (rotulo[raiz] < 0) {
+                rotulo[raiz] = total++;
+            }
+            rotulo[i] = rotulo[raiz];
+        }
+    }
+    return c->numComponentes;
+}
+
+/// @brief Devolve o número de componentes ligadas do grafo
+/// @param g Apontador para o grafo
+/// @return Número de componentes, ou -1 se falhar a alocação
+int contarComponentes(Grafo* g) {
+    return rotularComponentes(g, NULL);
+}
+
+/// @brief Devolve o número de vértices da componente de uma antena
+/// @param g Apontador para o grafo
+/// @param v Vértice do grafo
+/// @return Tamanho da componente, ou -1 se o vértice for inválido ou falhar a alocação
+int tamanhoComponente(Grafo* g, Vertice* v) {
+    if (g == NULL || !verticeDoGrafo(g, v) || !atualizarComponentes(g)) {
+        return -1;
+    }
+    return g->componentes.tamanho[raizComponente(&g->componentes, v->id)];
+}
+
+/// @brief Verifica se duas antenas estão na mesma componente ligada
+/// @param g Apontador para o grafo
+/// @param a Primeira antena
+/// @param b Segunda antena
+/// @return true se existir um caminho entre as duas
+bool mesmaComponente(Grafo* g, Vertice* a, Vertice* b) {
+    if (g == NULL || !verticeDoGrafo(g, a) || !verticeDoGrafo(g, b) || !atualizarComponentes(g)) {
+        return false;
+    }
+    return raizComponente(&g->componentes, a->id) == raizComponente(&g->componentes, b->id);
+}
+
+#pragma endregion
+
+#pragma region Funções do Grafo Compacto
+
+/// @brief Cria um grafo compacto vazio com espaço para n vértices e m arestas
+/// @param n Número de vértices
+/// @param m Número de arestas
+/// @return Apontador para o grafo compacto, ou NULL se falhar a alocação
+static GrafoCSR* alocarGrafoCSR(int n, int m) {
+    GrafoCSR* c = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+
+    if (c == NULL) {
+        return NULL;
+    }
+    c->numVertices = n;
+    c->numArestas = m;
+    c->metrica = DISTANCIA_MANHATTAN;
+    c->freq = (char*)malloc((size_t)n + 1);
+    c->x = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    c->y = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    c->inicio = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    c->destino = (int*)malloc(((size_t)m + 1) * sizeof(int));
+    if (!c->freq || !c->x || !c->y || !c->inicio || !c->destino) {
+        libertarGrafoCSR(c);
+        return NULL;
+    }
+    return c;
+}
+
+/// @brief Verifica os índices de um grafo compacto lido de um ficheiro: inicio começa em 0, nunca desce e termina
+///        em numArestas, e cada destino é um vértice existente
+/// @param c Apontador para o grafo compacto
+/// @return true se os índices forem válidos, false caso contrário
+static bool indicesCSRValidos(const GrafoCSR* c) {
+    bool ok = c->inicio[0] == 0 && c->inicio[c->numVertices] == c->numArestas;
+
+    for (int i = 0; ok && i < c->numVertices; i++) {
+        ok = c->inicio[i] <= c->inicio[i + 1];
+    }
+    for (int k = 0; ok && k < c->numArestas; k++) {
+        ok = c->destino[k] >= 0 && c->destino[k] < c->numVertices;
+    }
+    return ok;
+}
+
+/// @brief Cria a representação compacta (CSR) de um grafo, com os vértices pela ordem da lista
+/// @param g Apontador para o grafo
+/// @return Apontador para o grafo compacto, ou NULL se falhar a alocação
+GrafoCSR* congelarGrafo(Grafo* g) {
+    GrafoCSR* c;
+    int* posicao;
+    int i, m = 0;
+    Vertice* v;
+    Vertice* w;
+    IteradorVizinhos it;
+
+    if (g == NULL) {
+        return NULL;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    // Conta as arestas para saber o tamanho do vetor de destinos
+    for (v = g->h; v != NULL; v = v->prox) {
+        m += grauGrafo(g, v);
+    }
+
+    c = alocarGrafoCSR(g->numVertices, m);
+    if (c != NULL) {
+        c->metrica = g->metrica;
+    }
+    posicao = (int*)malloc(((size_t)g->numVertices + 1) * sizeof(int));
+    if (c == NULL || posicao == NULL) {
+        libertarGrafoCSR(c);
+        free(posicao);
+        return NULL;
+    }
+
+    // Os vértices ficam pela ordem da lista (ordenados por coordenadas); posicao[id] guarda o índice de cada um
+    i = 0;
+    for (v = g->h; v != NULL; v = v->prox) {
+        posicao[v->id] = i;
+        c->freq[i] = v->freq;
+        c->x[i] = v->x;
+        c->y[i] = v->y;
+        i++;
+    }
+
+    // As arestas de cada vértice ficam seguidas, pela ordem do iterador (as ligações implícitas passam a arestas)
+    i = 0;
+    m = 0;
+    for (v = g->h; v != NULL; v = v->prox) {
+        c->inicio[i++] = m;
+        iniciarVizinhos(g, v, &it);
+        while ((w = proximoVizinho(&it)) != NULL) {
+            c->destino[m++] = posicao[w->id];
+        }
+    }
+    c->inicio[c->numVertices] = m;
+
+    free(posicao);
+    TERMINAR_TEMPO(tempoInicio, FASE_CONGELAR);
+    return c;
+}
+
+/// @brief Cria um grafo editável (listas ligadas) a partir de um grafo compacto
+/// @param c Apontador para o grafo compacto
+/// @return Apontador para o novo grafo, ou NULL se falhar a alocação ou os dados forem inválidos
+Grafo* criarGrafoDeCSR(GrafoCSR* c) {
+    Grafo* g;
+    Vertice** porIndice;
+    bool ok;
+    int i, k;
+
+    if (c == NULL) {
+        return NULL;
+    }
+
+    g = criarGrafo();
+    porIndice = (Vertice**)malloc(((size_t)c->numVertices + 1) * sizeof(Vertice*));
+    ok = (g != NULL && porIndice != NULL);
+    if (g != NULL) {
+        // A métrica é definida antes das arestas, para os pesos serem calculados com ela
+        g->metrica = c->metrica;
+    }
+
+    // Cria os vértices pela ordem do grafo compacto (já ordenada, por isso cada inserção é feita no fim da lista)
+    for (i = 0; ok && i < c->numVertices; i++) {
+        porIndice[i] = inserirAntenaGrafo(g, c->freq[i], c->x[i], c->y[i]);
+        ok = (porIndice[i] != NULL);
+    }
+
+    // Cria as arestas numa só passagem; são inseridas do fim para o início para manter a ordem original
+    for (i = 0; ok && i < c->numVertices; i++) {
+        if (c->inicio[i] < 0 || c->inicio[i] > c->inicio[i + 1] || c->inicio[i + 1] > c->numArestas) {
+            ok = false;
+            break;
+        }
+        for (k = c->inicio[i + 1]; k-- > c->inicio[i]; ) {
+            if (c->destino[k] < 0 || c->destino[k] >= c->numVertices) {
+                ok = false;
+                break;
+            }
+            Aresta* novaAdj = criarAdjacenciaGrafo(g, porIndice[i], porIndice[c->destino[k]]);
+            if (novaAdj != NULL) {
+                inserirAdjacencia(porIndice[i], novaAdj);
+            }
+        }
+    }
+
+    free(porIndice);
+    if (!ok) {
+        libertarGrafo(g);
+        return NULL;
+    }
+    return g;
+}
+
+/// @brief Devolve o número de arestas de um vértice do grafo compacto, em O(1)
+/// @param c Apontador para o grafo compacto
+/// @param v Índice do vértice
+/// @return Número de arestas do vértice (0 se o índice for inválido)
+int grauCSR(GrafoCSR* c, int v) {
+    if (c == NULL || v < 0 || v >= c->numVertices) {
+        return 0;
+    }
+    return c->inicio[v + 1] - c->inicio[v];
+}
+
+/// @brief Procura um vértice do grafo compacto pelas coordenadas (pesquisa binária, os vértices estão ordenados)
+/// @param c Apontador para o grafo compacto
+/// @param x Coordenada X
+/// @param y Coordenada Y
+/// @return Índice do vértice, ou -1 se não existir
+int procurarVerticeCSR(GrafoCSR* c, int x, int y) {
+    int baixo = 0, alto, meio;
+
+    if (c == NULL) {
+        return -1;
+    }
+
+    alto = c->numVertices - 1;
+    while (baixo <= alto) {
+        meio = baixo + (alto - baixo) / 2;
+        if (c->x[meio] == x && c->y[meio] == y) {
+            return meio;
+        }
+        if (c->x[meio] < x || (c->x[meio] == x && c->y[meio] < y)) {
+            baixo = meio + 1;
+        } else {
+            alto = meio - 1;
+        }
+    }
+    return -1;
+}
+
+/// @brief Percurso em profundidade (DFS) iterativo sobre o grafo compacto, com uma pilha explícita
+///        (a ordem de visita é a mesma do percurso recursivo sobre as listas de adjacências)
+/// @param c Apontador para o grafo compacto
+/// @param origem Índice do vértice onde começa o percurso
+/// @param visitado Vetor com uma posição por vértice (diferente de 0 = visitado); pode ser NULL
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices índices); pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int depthFirstTraversalCSR(GrafoCSR* c, int origem, char* visitado, int* ordem) {
+    int *pilhaVertice, *pilhaAresta;
+    char* proprio = NULL;
+    int topo = 0, total = 0, v, w;
+
+    if (c == NULL || origem < 0 || origem >= c->numVertices) {
+        return -1;
+    }
+
+    // Sem vetor de visitados do chamador, usa um vetor próprio
+    if (visitado == NULL) {
+        proprio = (char*)calloc((size_t)c->numVertices, 1);
+        visitado = proprio;
+    }
+
+    // Cada vértice entra na pilha no máximo uma vez, por isso n posições chegam
+    pilhaVertice = (int*)malloc((size_t)c->numVertices * sizeof(int));
+    pilhaAresta = (int*)malloc((size_t)c->numVertices * sizeof(int));
+    if (visitado == NULL || pilhaVertice == NULL || pilhaAresta == NULL) {
+        free(proprio);
+        free(pilhaVertice);
+        free(pilhaAresta);
+        return -1;
+    }
+
+    if (!visitado[origem]) {
+        visitado[origem] = 1;
+        if (ordem != NULL) {
+            ordem[total] = origem;
+        }
+        total++;
+        pilhaVertice[0] = origem;
+        pilhaAresta[0] = c->inicio[origem];
+        topo = 1;
+    }
+
+    while (topo > 0) {
+        v = pilhaVertice[topo - 1];
+
+        // Avança pelas arestas do vértice do topo até encontrar um destino por visitar
+        if (pilhaAresta[topo - 1] < c->inicio[v + 1]) {
+            w = c->destino[pilhaAresta[topo - 1]++];
+            if (!visitado[w]) {
+                visitado[w] = 1;
+                if (ordem != NULL) {
+                    ordem[total] = w;
+                }
+                total++;
+                pilhaVertice[topo] = w;
+                pilhaAresta[topo] = c->inicio[w];
+                topo++;
+            }
+        } else {
+            // Todas as arestas foram vistas: volta ao vértice anterior
+            topo--;
+        }
+    }
+
+    free(proprio);
+    free(pilhaVertice);
+    free(pilhaAresta);
+    return total;
+}
+
+/// @brief Liberta a memória do grafo compacto
+/// @param c Apontador para o grafo compacto
+void libertarGrafoCSR(GrafoCSR* c) {
+    if (c != NULL) {
+        free(c->freq);
+        free(c->x);
+        free(c->y);
+        free(c->inicio);
+        free(c->destino);
+        free(c);
+    }
+}
+
+#pragma endregion
+
+#pragma region Funções de Percursos
+/// @brief Vértice guardado na pilha dos percursos legados, com a próxima aresta a seguir
+typedef struct PosicaoPercurso {
+    Vertice* v;                 //Vértice
+    Aresta* aresta;             //Próxima aresta do vértice a ver
+} PosicaoPercurso;
+
+/// @brief Garante espaço para mais uma posição num vetor que cresce por duplicação (pilha ou fila dos percursos legados)
+/// @param vetor Apontador para o vetor
+/// @param capacidade Apontador para o número de posições alocadas
+/// @param usadas Número de posições usadas
+/// @param tamanho Tamanho de cada posição em bytes
+/// @return true se houver espaço, false se falhar a alocação
+static bool reservarPosicao(void** vetor, int* capacidade, int usadas, size_t tamanho) {
+    if (usadas == *capacidade) {
+        int nova = (*capacidade == 0) ? 64 : *capacidade * 2;
+        void* aux = realloc(*vetor, (size_t)nova * tamanho);
+        if (aux == NULL) {
+            return false;
+        }
+        *vetor = aux;
+        *capacidade = nova;
+    }
+    return true;
+}
+
+/// @brief Realiza um percurso em profundidade (DFS) a partir de uma antena, com uma pilha explícita em vez de recursão
+///        (marca o campo 'visitado'; usar resetVisitado antes de um novo percurso)
+/// @param origem Vértice de início do percurso
+/// @return true se o percurso foi feito, false se a origem for inválida ou falhar a alocação
+bool depthFirstTraversal(Vertice* origem) {
+    PosicaoPercurso* pilha = NULL;
+    int capacidade = 0, topo = 0;
+    Aresta* aux;
+
+    // Verifica se o vértice de origem é válido
+    if (origem == NULL) {
+        return false;
+    }
+
+    // Marca o vértice de origem como visitado e coloca-o na pilha
+    origem->visitado = 1;
+    if (!reservarPosicao((void**)&pilha, &capacidade, topo, sizeof(PosicaoPercurso))) {
+        return false;
+    }
+    pilha[topo].v = origem;
+    pilha[topo].aresta = origem->adj;
+    topo++;
+
+    while (topo > 0) {
+        // Avança pelas adjacências do vértice do topo
+        aux = pilha[topo - 1].aresta;
+        if (aux == NULL) {
+            // Sem mais adjacências: volta ao vértice anterior
+            topo--;
+            continue;
+        }
+        pilha[topo - 1].aresta = aux->prox;
+
+        // Se o vértice de destino ainda não foi visitado, desce para ele
+        if (aux->destino->visitado == 0) {
+            aux->destino->visitado = 1;
+            if (!reservarPosicao((void**)&pilha, &capacidade, topo, sizeof(PosicaoPercurso))) {
+                free(pilha);
+                return false;
+            }
+            pilha[topo].v = aux->destino;
+            pilha[topo].aresta = aux->destino->adj;
+            topo++;
+        }
+    }
+
+    free(pilha);
+    return true;
+}
+
+/// @brief Realiza um percurso em largura (BFS) a partir de uma antena, com uma fila
+///        (marca o campo 'visitado'; usar resetVisitado antes de um novo percurso)
+/// @param origem Vértice de início do percurso
+/// @return true se o percurso foi feito, false se a origem for inválida ou falhar a alocação
+bool breadthFirstTraversal(Vertice* origem) {
+    Vertice** fila = NULL;
+    int capacidade = 0, inicio = 0, fim = 0;
+    Aresta* aux;
+
+    // Verifica se o vértice de origem é válido
+    if (origem == NULL) {
+        return false;
+    }
+
+    origem->visitado = 1;
+    if (!reservarPosicao((void**)&fila, &capacidade, fim, sizeof(Vertice*))) {
+        return false;
+    }
+    fila[fim++] = origem;
+
+    // Cada vértice entra na fila uma única vez (quando é marcado), por isso a fila nunca é esvaziada pelo início
+    while (inicio < fim) {
+        for (aux = fila[inicio++]->adj; aux != NULL; aux = aux->prox) {
+            if (aux->destino->visitado == 0) {
+                aux->destino->visitado = 1;
+                if (!reservarPosicao((void**)&fila, &capacidade, fim, sizeof(Vertice*))) {
+                    free(fila);
+                    return false;
+                }
+                fila[fim++] = aux->destino;
+            }
+        }
+    }
+
+    free(fila);
+    return true;
+}
+
+/// @brief Faz com que os membros de uma frequência só sejam percorridos pelo primeiro vértice que a expande:
+///        esse vértice acaba por ver todos os membros, por isso os seguintes só seguem as arestas guardadas
+/// @param it Iterador acabado de preparar
+/// @param expandida Frequências já expandidas no percurso
+static void expandirUmaVez(IteradorVizinhos* it, bool* expandida) {
+    if (!it->semMembros) {
+        if (expandida[(unsigned char)it->v->freq]) {
+            it->semMembros = true;
+        } else {
+            expandida[(unsigned char)it->v->freq] = true;
+        }
+    }
+}
+
+/// @brief Valida a origem de um percurso e prepara o conjunto de visitados
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param alcancados Conjunto dado pelo chamador (pode ser NULL)
+/// @param proprio Apontador onde é devolvido o conjunto alocado quando alcancados é NULL (para libertar no fim)
+/// @return Conjunto de visitados a usar, ou NULL se a origem for inválida ou falhar a alocação
+static uint64_t* prepararPercurso(Grafo* g, Vertice* origem, uint64_t* alcancados, uint64_t** proprio) {
+    *proprio = NULL;
+    if (g == NULL || !verticeDoGrafo(g, origem)) {
+        return NULL;
+    }
+    if (alcancados != NULL) {
+        return alcancados;
+    }
+    *proprio = (uint64_t*)calloc(((size_t)g->numVertices + 63) / 64, sizeof(uint64_t));
+    return *proprio;
+}
+
+/// @brief Marca um vértice como visitado no conjunto de bits
+/// @param visitados Conjunto de bits indexado pelo id
+/// @param v Vértice a marcar
+/// @return true se o vértice ainda não estava marcado
+static inline bool marcarVisitado(uint64_t* visitados, Vertice* v) {
+    uint64_t bit = 1ULL << (v->id & 63);
+
+    if (visitados[v->id >> 6] & bit) {
+        return false;
+    }
+    visitados[v->id >> 6] |= bit;
+    return true;
+}
+
+/// @brief Percurso em profundidade (DFS) iterativo, com pilha pré-alocada e conjunto de visitados em bits
+///        (não usa o campo 'visitado' dos vértices, por isso não precisa de resetVisitado; segue as ligações implícitas)
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param visitar Função chamada para cada vértice quando é descoberto (pode ser NULL); se devolver false o percurso termina
+/// @param contexto Apontador passado a visitar
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices vértices); pode ser NULL
+/// @param alcancados Conjunto de bits indexado pelo id ((numVertices + 63) / 64 palavras) onde ficam os vértices alcançados;
+///                   os vértices já marcados não são visitados; pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int percursoProfundidade(Grafo* g, Vertice* origem, VisitarVertice visitar, void* contexto, Vertice** ordem, uint64_t* alcancados) {
+    bool expandida[NUM_FREQUENCIAS] = { false };
+    IteradorVizinhos* pilha;
+    uint64_t* proprio;
+    uint64_t* visitados;
+    int topo, total = 0;
+    Vertice* w;
+    INICIAR_TEMPO(tempoInicio);
+
+    visitados = prepararPercurso(g, origem, alcancados, &proprio);
+    if (visitados == NULL) {
+        return -1;
+    }
+    if (!marcarVisitado(visitados, origem)) {
+        free(proprio);
+        return 0;
+    }
+
+    // Cada vértice entra na pilha no máximo uma vez, por isso numVertices posições chegam
+    pilha = (IteradorVizinhos*)malloc((size_t)g->numVertices * sizeof(IteradorVizinhos));
+    if (pilha == NULL) {
+        free(proprio);
+        return -1;
+    }
+
+    w = origem;
+    topo = 0;
+    while (w != NULL) {
+        // Visita o vértice descoberto e coloca-o no topo da pilha
+        if (ordem != NULL) {
+            ordem[total] = w;
+        }
+        total++;
+        if (visitar != NULL && !visitar(w, topo, contexto)) {
+            break;
+        }
+        iniciarVizinhos(g, w, &pilha[topo]);
+        expandirUmaVez(&pilha[topo], expandida);
+        topo++;
+
+        // Procura o próximo vértice por visitar, recuando enquanto o topo não tiver mais vizinhos
+        w = NULL;
+        while (topo > 0 && w == NULL) {
+            w = proximoVizinho(&pilha[topo - 1]);
+            if (w == NULL) {
+                topo--;
+            } else if (!marcarVisitado(visitados, w)) {
+                w = NULL;
+            }
+        }
+    }
+
+    free(pilha);
+    free(proprio);
+    TERMINAR_TEMPO(tempoInicio, FASE_PERCURSOS);
+    return total;
+}
+
+/// @brief Percurso em largura (BFS), com fila pré-alocada e conjunto de visitados em bits
+///        (não usa o campo 'visitado' dos vértices, por isso não precisa de resetVisitado; segue as ligações implícitas)
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param visitar Função chamada para cada vértice quando é descoberto, com a distância em arestas à origem (pode ser NULL);
+///                se devolver false o percurso termina
+/// @param contexto Apontador passado a visitar
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices vértices); pode ser NULL
+/// @param alcancados Conjunto de bits indexado pelo id ((numVertices + 63) / 64 palavras) onde ficam os vértices alcançados;
+///                   os vértices já marcados não são visitados; pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int percursoLargura(Grafo* g, Vertice* origem, VisitarVertice visitar, void* contexto, Vertice** ordem, uint64_t* alcancados) {
+    bool expandida[NUM_FREQUENCIAS] = { false };
+    IteradorVizinhos it;
+    Vertice** fila;
+    uint64_t* proprio;
+    uint64_t* visitados;
+    int inicio = 0, fim = 0, fimNivel, nivel = 0;
+    Vertice* w;
+    INICIAR_TEMPO(tempoInicio);
+
+    visitados = prepararPercurso(g, origem, alcancados, &proprio);
+    if (visitados == NULL) {
+        return -1;
+    }
+    if (!marcarVisitado(visitados, origem)) {
+        free(proprio);
+        return 0;
+    }
+
+    // A fila só cresce (cada vértice entra uma vez), por isso pode ser também o vetor da ordem de visita
+    fila = (ordem != NULL) ? ordem : (Vertice**)malloc((size_t)g->numVertices * sizeof(Vertice*));
+    if (fila == NULL) {
+        free(proprio);
+        return -1;
+    }
+
+    fila[fim++] = origem;
+    if (visitar != NULL && !visitar(origem, 0, contexto)) {
+        inicio = fim;
+    }
+
+    // Processa a fila por níveis: os vértices entre inicio e fimNivel estão todos à mesma distância da origem
+    while (inicio < fim) {
+        fimNivel = fim;
+        nivel++;
+        while (inicio < fimNivel) {
+            iniciarVizinhos(g, fila[inicio++], &it);
+            expandirUmaVez(&it, expandida);
+            while ((w = proximoVizinho(&it)) != NULL) {
+                if (marcarVisitado(visitados, w)) {
+                    fila[fim++] = w;
+                    if (visitar != NULL && !visitar(w, nivel, contexto)) {
+                        inicio = fimNivel = fim;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    if (fila != ordem) {
+        free(fila);
+    }
+    free(proprio);
+    TERMINAR_TEMPO(tempoInicio, FASE_PERCURSOS);
+    return fim;
+}
+
+/// @brief Percurso em profundidade (DFS) iterativo sobre o grafo, que segue também as ligações implícitas
+///        (cada frequência implícita é expandida uma única vez, por isso o custo é O(V + arestas guardadas))
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices vértices); pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int depthFirstTraversalGrafo(Grafo* g, Vertice* origem, Vertice** ordem) {
+    return percursoProfundidade(g, origem, NULL, NULL, ordem, NULL);
+}
+
+#pragma endregion
+
+#pragma region Funções de Caminhos Mais Curtos
+/// @brief Fila de prioridade (heap binária mínima) de vértices indexada pelo id, com diminuição de chave em O(log n)
+typedef struct FilaPrioridade {
+    int* heap;                  //Ids dos vértices, organizados em heap pela chave
+    int* posicao;               //Posição de cada id na heap (-1 se não estiver na fila)
+    int64_t* chave;             //Chave de cada id
+    int n;                      //Número de elementos na fila
+} FilaPrioridade;
+
+/// @brief Cria uma fila vazia para ids entre 0 e capacidade-1
+/// @param f Fila a preparar
+/// @param capacidade Número de ids possíveis
+/// @return true se conseguiu, false se falhar a alocação
+static bool criarFilaPrioridade(FilaPrioridade* f, int capacidade) {
+    f->heap = (int*)malloc(((size_t)capacidade + 1) * sizeof(int));
+    f->posicao = (int*)malloc(((size_t)capacidade + 1) * sizeof(int));
+    f->chave = (int64_t*)malloc(((size_t)capacidade + 1) * sizeof(int64_t));
+    f->n = 0;
+    if (f->heap == NULL || f->posicao == NULL || f->chave == NULL) {
+        free(f->heap);
+        free(f->posicao);
+        free(f->chave);
+        return false;
+    }
+    memset(f->posicao, -1, (size_t)capacidade * sizeof(int));
+    return true;
+}
+
+/// @brief Liberta a memória da fila
+/// @param f Fila a libertar
+static void libertarFilaPrioridade(FilaPrioridade* f) {
+    free(f->heap);
+    free(f->posicao);
+    free(f->chave);
+}
+
+/// @brief Sobe um elemento na heap até a chave do pai não ser maior
+/// @param f Fila
+/// @param i Posição do elemento
+static void subirFila(FilaPrioridade* f, int i) {
+    int id = f->heap[i];
+
+    while (i > 0 && f->chave[f->heap[(i - 1) / 2]] > f->chave[id]) {
+        f->heap[i] = f->heap[(i - 1) / 2];
+        f->posicao[f->heap[i]] = i;
+        i = (i - 1) / 2;
+    }
+    f->heap[i] = id;
+    f->posicao[id] = i;
+}
+
+/// @brief Desce um elemento na heap até nenhum filho ter chave menor
+/// @param f Fila
+/// @param i Posição do elemento
+static void descerFila(FilaPrioridade* f, int i) {
+    int id = f->heap[i];
+    int filho;
+
+    while ((filho = 2 * i + 1) < f->n) {
+        if (filho + 1 < f->n && f->chave[f->heap[filho + 1]] < f->chave[f->heap[filho]]) {
+            filho++;
+        }
+        if (f->chave[f->heap[filho]] >= f->chave[id]) {
+            break;
+        }
+        f->heap[i] = f->heap[filho];
+        f->posicao[f->heap[i]] = i;
+        i = filho;
+    }
+    f->heap[i] = id;
+    f->posicao[id] = i;
+}
+
+/// @brief Coloca um id na fila, ou diminui a sua chave se já lá estiver
+/// @param f Fila
+/// @param id Id do vértice
+/// @param chave Nova chave
+static void colocarFila(FilaPrioridade* f, int id, int64_t chave) {
+    f->chave[id] = chave;
+    if (f->posicao[id] < 0) {
+        f->heap[f->n] = id;
+        f->posicao[id] = f->n;
+        f->n++;
+    }
+    subirFila(f, f->posicao[id]);
+}
+
+/// @brief Retira da fila o id com a menor chave
+/// @param f Fila (não vazia)
+/// @return Id retirado
+static int retirarFila(FilaPrioridade* f) {
+    int id = f->heap[0];
+
+    f->posicao[id] = -1;
+    f->n--;
+    if (f->n > 0) {
+        f->heap[0] = f->heap[f->n];
+        descerFila(f, 0);
+    }
+    return id;
+}
+
+/// @brief Estimativa do custo que falta até ao destino, que nunca excede o custo real (para o A*)
+/// @param g Apontador para o grafo
+/// @param v Vértice atual
+/// @param destino Vértice de chegada
+/// @return Distância em linha reta (na métrica do grafo, com a euclidiana arredondada para baixo)
+static int64_t estimativaDestino(Grafo* g, Vertice* v, Vertice* destino) {
+    int64_t dx = (int64_t)v->x - destino->x;
+    int64_t dy = (int64_t)v->y - destino->y;
+
+    if (g->metrica == DISTANCIA_EUCLIDIANA) {
+        return (int64_t)raizInteira((uint64_t)(dx * dx) + (uint64_t)(dy * dy));
+    }
+    return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+/// @brief Motor comum do Dijkstra e do A*: fixa os vértices por ordem de distância (mais estimativa, no A*)
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param destino Vértice de chegada (NULL para calcular as distâncias a todos)
+/// @param heuristica Se true, usa estimativaDestino (A*); exige destino
+/// @param distancia Vetor indexado pelo id com as distâncias (-1 se não alcançado)
+/// @param anterior Vetor indexado pelo id com o vértice anterior (pode ser NULL)
+/// @return true se conseguiu, false se falhar a alocação
+static bool procurarCaminhos(Grafo* g, Vertice* origem, Vertice* destino, bool heuristica, int64_t* distancia, int* anterior) {
+    FilaPrioridade fila;
+    IteradorVizinhos it;
+    Vertice* v;
+    Vertice* w;
+    int64_t nova;
+    int id;
+    INICIAR_TEMPO(tempoInicio);
+
+    if (!criarFilaPrioridade(&fila, g->numVertices)) {
+        return false;
+    }
+
+    for (int i = 0; i < g->numVertices; i++) {
+        distancia[i] = -1;
+        if (anterior != NULL) {
+            anterior[i] = -1;
+        }
+    }
+
+    distancia[origem->id] = 0;
+    colocarFila(&fila, origem->id, heuristica ? estimativaDestino(g, origem, destino) : 0);
+
+    while (fila.n > 0) {
+        id = retirarFila(&fila);
+        v = g->vertices[id];
+
+        // Quando o destino sai da fila, a sua distância já é a mínima
+        if (v == destino) {
+            break;
+        }
+
+        iniciarVizinhos(g, v, &it);
+        while ((w = proximoVizinho(&it)) != NULL) {
+            nova = distancia[id] + it.peso;
+            if (distancia[w->id] < 0 || nova < distancia[w->id]) {
+                distancia[w->id] = nova;
+                if (anterior != NULL) {
+                    anterior[w->id] = id;
+                }
+                colocarFila(&fila, w->id, heuristica ? nova + estimativaDestino(g, w, destino) : nova);
+            }
+        }
+    }
+
+    libertarFilaPrioridade(&fila);
+    TERMINAR_TEMPO(tempoInicio, FASE_CAMINHOS);
+    return true;
+}
+
+/// @brief Distâncias mínimas (soma dos pesos) de uma antena a todas as outras, pelo algoritmo de Dijkstra com uma heap binária
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param distancia Vetor indexado pelo id (numVertices posições) onde fica a distância de cada vértice (-1 se não for alcançável)
+/// @param anterior Vetor indexado pelo id onde fica o id do vértice anterior no caminho mínimo (-1 na origem e nos não alcançáveis); pode ser NULL
+/// @return true se conseguiu, false se a origem for inválida ou falhar a alocação
+bool distanciasDesde(Grafo* g, Vertice* origem, int64_t* distancia, int* anterior) {
+    if (g == NULL || distancia == NULL || !verticeDoGrafo(g, origem)) {
+        return false;
+    }
+    return procurarCaminhos(g, origem, NULL, false, distancia, anterior);
+}
+
+/// @brief Calcula o caminho entre duas antenas com Dijkstra ou A* e reconstrói-o a partir dos vértices anteriores
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param destino Vértice de chegada
+/// @param heuristica Se true usa o A*, senão o Dijkstra
+/// @param caminho Vetor para os vértices do caminho (pode ser NULL)
+/// @param max Número de posições de caminho
+/// @param tamanho Apontador para o número de vértices do caminho (pode ser NULL)
+/// @return Custo do caminho, -1 se não for alcançável, -2 em caso de erro, -3 se o caminho não couber em caminho
+static int64_t caminhoEntre(Grafo* g, Vertice* origem, Vertice* destino, bool heuristica, Vertice** caminho, int max, int* tamanho) {
+    int64_t* distancia;
+    int* anterior;
+    int64_t custo;
+    int n = 0;
+
+    if (tamanho != NULL) {
+        *tamanho = 0;
+    }
+    if (g == NULL || !verticeDoGrafo(g, origem) || !verticeDoGrafo(g, destino)) {
+        return -2;
+    }
+
+    distancia = (int64_t*)malloc((size_t)g->numVertices * sizeof(int64_t));
+    anterior = (int*)malloc((size_t)g->numVertices * sizeof(int));
+    if (distancia == NULL || anterior == NULL || !procurarCaminhos(g, origem, destino, heuristica, distancia, anterior)) {
+        free(distancia);
+        free(anterior);
+        return -2;
+    }
+
+    custo = distancia[destino->id];
+    if (custo >= 0) {
+        // Conta os vértices do destino até à origem e escreve-os pela ordem inversa
+        for (int id = destino->id; id >= 0; id = anterior[id]) {
+            n++;
+        }
+        if (caminho != NULL && n > max) {
+            custo = -3;         // O caminho não cabe no vetor dado: não escreve nada
+        } else if (caminho != NULL) {
+            int i = n;
+            for (int id = destino->id; id >= 0; id = anterior[id]) {
+                caminho[--i] = g->vertices[id];
+            }
+        }
+        if (tamanho != NULL) {
+            *tamanho = n;
+        }
+    }
+
+    free(distancia);
+    free(anterior);
+    return custo;
+}
+
+/// @brief Caminho mínimo entre duas antenas, pelo algoritmo de Dijkstra (termina quando o destino é fixado)
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param destino Vértice de chegada
+/// @param caminho Vetor onde são escritos os vértices do caminho, da origem ao destino; pode ser NULL
+/// @param max Número de posições de caminho
+/// @param tamanho Apontador onde fica o número de vértices do caminho (mesmo que não caibam em caminho); pode ser NULL
+/// @return Custo do caminho, -1 se o destino não for alcançável, -2 se os vértices forem inválidos ou falhar a alocação,
+///         ou -3 se o caminho tiver mais de max vértices (nada é escrito em caminho)
+int64_t caminhoMaisCurto(Grafo* g, Vertice* origem, Vertice* destino, Vertice** caminho, int max, int* tamanho) {
+    return caminhoEntre(g, origem, destino, false, caminho, max, tamanho);
+}
+
+/// @brief Caminho mínimo entre duas antenas pelo algoritmo A*, guiado pela distância em linha reta ao destino
+///        (a estimativa nunca excede o custo real e respeita a desigualdade triangular, por isso o custo é o mínimo)
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param destino Vértice de chegada
+/// @param caminho Vetor onde são escritos os vértices do caminho, da origem ao destino; pode ser NULL
+/// @param max Número de posições de caminho
+/// @param tamanho Apontador onde fica o número de vértices do caminho (mesmo que não caibam em caminho); pode ser NULL
+/// @return Custo do caminho, -1 se o destino não for alcançável, -2 se os vértices forem inválidos ou falhar a alocação,
+///         ou -3 se o caminho tiver mais de max vértices (nada é escrito em caminho)
+int64_t caminhoAEstrela(Grafo* g, Vertice* origem, Vertice* destino, Vertice** caminho, int max, int* tamanho) {
+    return caminhoEntre(g, origem, destino, true, caminho, max, tamanho);
+}
+
+#pragma endregion
+
+#pragma region Funções de Ficheiros
+/// @brief Coloca o conteúdo completo de um ficheiro em memória (mmap em POSIX, leitura num só bloco nos restantes sistemas)
+/// @param nomeFicheiro Nome do ficheiro a abrir
+/// @param tamanho Apontador onde é devolvido o número de bytes do ficheiro
+/// @return Devolve o início dos dados ou NULL se o ficheiro não abrir
+static char* mapearFicheiro(const char* nomeFicheiro, size_t* tamanho) {
+#ifdef _WIN32
+    FILE* fp = fopen(nomeFicheiro, "rb");
+    char* dados;
+    long n;
+
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    dados = (char*)malloc(n > 0 ? (size_t)n : 1);
+    if (dados == NULL || fread(dados, 1, (size_t)n, fp) != (size_t)n) {
+        free(dados);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *tamanho = (size_t)n;
+    return dados;
+#else
+    struct stat info;
+    char* dados;
+    int fd = open(nomeFicheiro, O_RDONLY);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    *tamanho = (size_t)info.st_size;
+
+    // Um ficheiro vazio não pode ser mapeado, mas é um mapa válido sem antenas
+    if (*tamanho == 0) {
+        close(fd);
+        return (char*)"";
+    }
+
+    dados = (char*)mmap(NULL, *tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                      // O mapeamento continua válido depois de fechar o descritor
+    if (dados == MAP_FAILED) {
+        return NULL;
+    }
+    madvise(dados, *tamanho, MADV_SEQUENTIAL);
+    return dados;
+#endif
+}
+
+/// @brief Liberta os dados devolvidos por mapearFicheiro
+/// @param dados Início dos dados
+/// @param tamanho Número de bytes dos dados
+static void desmapearFicheiro(char* dados, size_t tamanho) {
+#ifdef _WIN32
+    (void)tamanho;
+    free(dados);
+#else
+    if (tamanho > 0) {
+        munmap(dados, tamanho);
+    }
+#endif
+}
+
+/// @brief Procura o primeiro byte diferente de '.' analisando 8 bytes de cada vez
+/// @param p Início da zona a analisar
+/// @param fim Fim (exclusivo) da zona a analisar
+/// @return Devolve o apontador para o primeiro byte diferente de '.', ou fim se não existir
+static const char* procurarNaoPonto(const char* p, const char* fim) {
+    const uint64_t pontos = 0x2E2E2E2E2E2E2E2EULL;     // Oito caracteres '.'
+    uint64_t v;
+
+    // Depois do XOR com os pontos, uma palavra a zero significa oito posições vazias seguidas
+    while (fim - p >= 8) {
+        memcpy(&v, p, 8);
+        v ^= pontos;
+        if (v != 0) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            return p + (__builtin_clzll(v) >> 3);
+#else
+            return p + (__builtin_ctzll(v) >> 3);
+#endif
+        }
+        p += 8;
+    }
+    while (p < fim && *p == '.') {
+        p++;
+    }
+    return p;
+}
+
+/// @brief Cria um grafo (lista ligada de antenas) a partir de um ficheiro de texto com o mapa da cidade
+/// @param nomeFicheiro Nome do ficheiro de entrada com o mapa
+/// @return Apontador para o grafo criado, ou NULL em caso de erro
+Grafo* criarGrafoDeFicheiro(char* nomeFicheiro) {
+    char* dados;
+    size_t tamanho;
+    const char *linha, *fimLinha, *fim, *p;
+    int x = 0, largura;
+    Grafo* g;
+
+    INICIAR_TEMPO(tempoInicio);
+
+    // Coloca o ficheiro inteiro em memória, em vez de o ler caractere a caractere
+    dados = mapearFicheiro(nomeFicheiro, &tamanho);
+    if (dados == NULL) {
+        return NULL;
+    }
+    CONTAR(bytesLidos, tamanho);
+
+    // Cria o grafo vazio (lista de vértices e índice de coordenadas)
+    g = criarGrafo();
+    if (!g) {
+        desmapearFicheiro(dados, tamanho);
+        return NULL;
+    }
+
+    // Percorre o mapa linha a linha (memchr encontra o fim de cada linha)
+    fim = dados + tamanho;
+    linha = dados;
+    while (linha < fim) {
+        fimLinha = (const char*)memchr(linha, '\n', (size_t)(fim - linha));
+        if (fimLinha == NULL) {
+            fimLinha = fim;
+        }
+
+        // Ignora o '\r' das linhas de ficheiros criados em Windows
+        largura = (int)(fimLinha - linha);
+        if (largura > 0 && linha[largura - 1] == '\r') {
+            largura--;
+        }
+
+        // Salta as posições vazias em blocos; cada caractere restante é uma antena
+        p = procurarNaoPonto(linha, linha + largura);
+        while (p < linha + largura) {
+            // O ficheiro é lido por ordem de (x,y), por isso cada antena vai para o fim da lista em O(1)
+            inserirAntenaGrafo(g, *p, x, (int)(p - linha));
+            p = procurarNaoPonto(p + 1, linha + largura);
+        }
+
+        x++;                        // Avança uma linha (vertical)
+        linha = fimLinha + 1;
+    }
+
+    desmapearFicheiro(dados, tamanho);
+    TERMINAR_TEMPO(tempoInicio, FASE_CARREGAR);
+
+    // Retorna o grafo criado com a lista de antenas
+    return g;
+}
+
+/*
+* Formato do ficheiro binário (versão 2), com inteiros de 32 bits na ordem de bytes da máquina (little-endian em x86/ARM):
+*   Cabeçalho:  "GRAF" | versão | número de vértices (n) | número de arestas (m)
+*   Vértices:   x[n] | y[n] | freq[n] (1 byte cada)
+*   Arestas:    inicio[n+1] | destino[m]
+* As arestas do vértice i são destino[inicio[i]] até destino[inicio[i+1]-1], e cada destino é o índice do vértice
+* no ficheiro. Assim a leitura não precisa de procurar vértices e não perde arestas para vértices ainda não lidos.
+*
+* A versão 3 tem as mesmas secções, em little-endian e cada uma a começar num múltiplo de 64 bytes, e o cabeçalho
+* guarda também a métrica, a posição de cada secção, o tamanho do ficheiro e uma soma de verificação (FNV-1a de 64 bits
+* de tudo o que vem depois do cabeçalho). Assim o ficheiro pode ser mapeado em memória e consultado no sítio
+* (abrirGrafoMapeado), sem leitura nem alocação, e as páginas são partilhadas entre processos que abram o mesmo ficheiro.
+*/
+#define FICHEIRO_MAGIA "GRAF"
+#define FICHEIRO_VERSAO 2
+#define FICHEIRO_VERSAO_MAPEAVEL 3
+#define FICHEIRO_VERSAO_COMPRIMIDA 4
+#define FICHEIRO_ALINHAMENTO 64         // Alinhamento das secções da versão 3 (uma linha de cache)
+#define FNV_BASE 0xCBF29CE484222325ULL
+#define FNV_PRIMO 0x100000001B3ULL
+
+// A versão 3 guarda os inteiros em little-endian; numa máquina big-endian é gravada a versão 2
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define FICHEIRO_SEM_MAPEAMENTO
+#endif
+
+/// @brief Cabeçalho do ficheiro binário
+typedef struct CabecalhoFicheiro {
+    char magia[4];
+    uint32_t versao;
+    uint32_t numVertices;
+    uint32_t numArestas;
+} CabecalhoFicheiro;
+
+/// @brief Secções do ficheiro binário, pela ordem em que são gravadas
+enum SeccaoFicheiro { SECCAO_X, SECCAO_Y, SECCAO_FREQ, SECCAO_INICIO, SECCAO_DESTINO, NUM_SECCOES };
+
+/// @brief Cabeçalho do ficheiro binário na versão 3 (começa com o cabeçalho das versões anteriores)
+typedef struct CabecalhoMapeavel {
+    CabecalhoFicheiro base;             // "GRAF" | 3 | n | m
+    uint32_t metrica;                   // Métrica dos pesos (MetricaDistancia)
+    uint32_t alinhamento;               // Alinhamento das secções (FICHEIRO_ALINHAMENTO)
+    uint64_t seccao[NUM_SECCOES];       // Posição de cada secção no ficheiro
+    uint64_t tamanho;                   // Número de bytes do ficheiro
+    uint64_t soma;                      // FNV-1a dos bytes depois do cabeçalho
+} CabecalhoMapeavel;
+
+/// @brief Acrescenta bytes a uma soma FNV-1a de 64 bits
+/// @param soma Soma até agora (FNV_BASE no início)
+/// @param dados Bytes a acrescentar
+/// @param n Número de bytes
+/// @return Nova soma
+static uint64_t somaFNV(uint64_t soma, const void* dados, size_t n) {
+    const unsigned char* p = (const unsigned char*)dados;
+
+    for (size_t i = 0; i < n; i++) {
+        soma = (soma ^ p[i]) * FNV_PRIMO;
+    }
+    return soma;
+}
+
+/// @brief Calcula o tamanho de cada secção da versão 3
+/// @param n Número de vértices
+/// @param m Número de arestas
+/// @param bytes Vetor onde é escrito o número de bytes de cada secção
+static void tamanhosSeccoes(uint64_t n, uint64_t m, uint64_t bytes[NUM_SECCOES]) {
+    bytes[SECCAO_X] = n * sizeof(int32_t);
+    bytes[SECCAO_Y] = n * sizeof(int32_t);
+    bytes[SECCAO_FREQ] = n;
+    bytes[SECCAO_INICIO] = (n + 1) * sizeof(int32_t);
+    bytes[SECCAO_DESTINO] = m * sizeof(int32_t);
+}
+
+/// @brief Grava um grafo compacto na versão 3: cada secção alinhada, seguida da soma de verificação no cabeçalho
+/// @param fp Ficheiro aberto para escrita, no início
+/// @param c Apontador para o grafo compacto
+/// @return true se a gravação for bem-sucedida
+static bool gravarSeccoesMapeaveis(FILE* fp, GrafoCSR* c) {
+    static const char zeros[FICHEIRO_ALINHAMENTO] = { 0 };
+    const void* dados[NUM_SECCOES] = { c->x, c->y, c->freq, c->inicio, c->destino };
+    uint64_t bytes[NUM_SECCOES];
+    CabecalhoMapeavel cab;
+    uint64_t pos = sizeof(cab), soma = FNV_BASE;
+    bool ok;
+    int s;
+
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.base.magia, FICHEIRO_MAGIA, 4);
+    cab.base.versao = FICHEIRO_VERSAO_MAPEAVEL;
+    cab.base.numVertices = (uint32_t)c->numVertices;
+    cab.base.numArestas = (uint32_t)c->numArestas;
+    cab.metrica = (uint32_t)c->metrica;
+    cab.alinhamento = FICHEIRO_ALINHAMENTO;
+
+    // As posições das secções são calculadas antes, para o cabeçalho ficar completo (só falta a soma)
+    tamanhosSeccoes(cab.base.numVertices, cab.base.numArestas, bytes);
+    for (s = 0; s < NUM_SECCOES; s++) {
+        pos = (pos + FICHEIRO_ALINHAMENTO - 1) / FICHEIRO_ALINHAMENTO * FICHEIRO_ALINHAMENTO;
+        cab.seccao[s] = pos;
+        pos += bytes[s];
+    }
+    cab.tamanho = pos;
+
+    ok = fwrite(&cab, sizeof(cab), 1, fp) == 1;
+    pos = sizeof(cab);
+    for (s = 0; ok && s < NUM_SECCOES; s++) {
+        // Os bytes de enchimento até ao início da secção são zeros e também entram na soma
+        size_t enchimento = (size_t)(cab.seccao[s] - pos);
+        ok = fwrite(zeros, 1, enchimento, fp) == enchimento
+          && fwrite(dados[s], 1, (size_t)bytes[s], fp) == (size_t)bytes[s];
+        soma = somaFNV(somaFNV(soma, zeros, enchimento), dados[s], (size_t)bytes[s]);
+        pos = cab.seccao[s] + bytes[s];
+    }
+
+    // A soma só é conhecida no fim, por isso o campo do cabeçalho é reescrito
+    cab.soma = soma;
+    return ok
+        && fseek(fp, (long)offsetof(CabecalhoMapeavel, soma), SEEK_SET) == 0
+        && fwrite(&cab.soma, sizeof(cab.soma), 1, fp) == 1;
+}
+
+#ifdef FICHEIRO_SEM_MAPEAMENTO
+/// @brief Grava um grafo compacto na versão 2: cabeçalho seguido das secções, sem enchimento
+/// @param fp Ficheiro aberto para escrita, no início
+/// @param c Apontador para o grafo compacto
+/// @return true se a gravação for bem-sucedida
+static bool gravarSeccoesCSR(FILE* fp, GrafoCSR* c) {
+    CabecalhoFicheiro cab;
+    uint32_t n = (uint32_t)c->numVertices, m = (uint32_t)c->numArestas;
+
+    memcpy(cab.magia, FICHEIRO_MAGIA, 4);
+    cab.versao = FICHEIRO_VERSAO;
+    cab.numVertices = n;
+    cab.numArestas = m;
+
+    // Os vetores do grafo compacto já estão no formato do ficheiro: cada secção é gravada com uma única escrita
+    return fwrite(&cab, sizeof(cab), 1, fp) == 1
+        && fwrite(c->x, sizeof(int32_t), n, fp) == n
+        && fwrite(c->y, sizeof(int32_t), n, fp) == n
+        && fwrite(c->freq, 1, n, fp) == n
+        && fwrite(c->inicio, sizeof(int32_t), n + 1, fp) == n + 1
+        && fwrite(c->destino, sizeof(int32_t), m, fp) == m;
+}
+#endif
+
+/// @brief Grava um grafo compacto no ficheiro binário (versão 3, ou versão 2 em máquinas big-endian):
+///        cabeçalho, tabela de vértices e arestas como índices de vértices
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param c Apontador para o grafo compacto
+/// @return true se a gravação for bem-sucedida, false em caso de erro.
+bool gravarFicheiroBinarioCSR(char* nomeFicheiro, GrafoCSR* c) {
+    bool ok;
+    FILE* fp;
+
+    // Verifica se o grafo existe
+    if (c == NULL) {
+        return false;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    // Abre o ficheiro em modo de escrita binária (cria novo ou substitui)
+    fp = fopen(nomeFicheiro, "wb");
+    if (fp == NULL) {
+        return false;
+    }
+
+#ifndef FICHEIRO_SEM_MAPEAMENTO
+    ok = gravarSeccoesMapeaveis(fp, c) && fseek(fp, 0, SEEK_END) == 0;
+#else
+    ok = gravarSeccoesCSR(fp, c);
+#endif
+
+    CONTAR(bytesEscritos, ftell(fp));
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    if (ok) {
+        TERMINAR_TEMPO(tempoInicio, FASE_GRAVAR);
+    }
+    return ok;
+}
+
+/// @brief Grava o grafo num ficheiro binário: cabeçalho, tabela de vértices e arestas como índices de vértices
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param g Apontador para o grafo
+/// @return true se a gravação for bem-sucedida, false em caso de erro.
+bool gravarFicheiroBinario(char* nomeFicheiro, Grafo* g) {
+    GrafoCSR* c = congelarGrafo(g);
+    bool ok = gravarFicheiroBinarioCSR(nomeFicheiro, c);
+
+    libertarGrafoCSR(c);
+    return ok;
+}
+
+/// @brief Mapeia um ficheiro na versão 3 e valida-o (abrirGrafoMapeado sem a medição do tempo)
+/// @param nomeFicheiro Caminho do ficheiro binário
+/// @param verificar true para confirmar a soma de verificação e a coerência das arestas
+/// @return Apontador para o grafo mapeado, ou NULL se o ficheiro não abrir ou for inválido
+static GrafoMapeado* mapearGrafo(char* nomeFicheiro, bool verificar) {
+#ifdef FICHEIRO_SEM_MAPEAMENTO
+    (void)nomeFicheiro;
+    (void)verificar;
+    return NULL;
+#else
+    CabecalhoMapeavel cab;
+    GrafoMapeado* g;
+    uint64_t bytes[NUM_SECCOES];
+    char* dados;
+    size_t tamanho;
+    bool ok;
+    int s;
+
+    dados = mapearFicheiro(nomeFicheiro, &tamanho);
+    if (dados == NULL) {
+        return NULL;
+    }
+
+    // Verificações em O(1): cabeçalho, tamanho do ficheiro e posição de cada secção
+    ok = tamanho >= sizeof(cab);
+    if (ok) {
+        memcpy(&cab, dados, sizeof(cab));
+        ok = memcmp(cab.base.magia, FICHEIRO_MAGIA, 4) == 0
+          && cab.base.versao == FICHEIRO_VERSAO_MAPEAVEL
+          && cab.base.numVertices <= INT32_MAX && cab.base.numArestas <= INT32_MAX
+          && cab.metrica <= DISTANCIA_EUCLIDIANA
+          && cab.tamanho == tamanho;
+    }
+    if (ok) {
+        tamanhosSeccoes(cab.base.numVertices, cab.base.numArestas, bytes);
+        for (s = 0; ok && s < NUM_SECCOES; s++) {
+            ok = cab.seccao[s] >= sizeof(cab) && cab.seccao[s] % sizeof(int32_t) == 0
+              && cab.seccao[s] <= tamanho && bytes[s] <= tamanho - cab.seccao[s];
+        }
+    }
+
+    g = ok ? (GrafoMapeado*)malloc(sizeof(GrafoMapeado)) : NULL;
+    if (g == NULL) {
+        desmapearFicheiro(dados, tamanho);
+        return NULL;
+    }
+
+    // Os vetores do grafo compacto apontam para o ficheiro: não há cópia nem conversão
+    g->dados = dados;
+    g->tamanho = tamanho;
+    g->csr.numVertices = (int)cab.base.numVertices;
+    g->csr.numArestas = (int)cab.base.numArestas;
+    g->csr.metrica = (MetricaDistancia)cab.metrica;
+    g->csr.x = (int*)(dados + cab.seccao[SECCAO_X]);
+    g->csr.y = (int*)(dados + cab.seccao[SECCAO_Y]);
+    g->csr.freq = dados + cab.seccao[SECCAO_FREQ];
+    g->csr.inicio = (int*)(dados + cab.seccao[SECCAO_INICIO]);
+    g->csr.destino = (int*)(dados + cab.seccao[SECCAO_DESTINO]);
+
+    ok = g->csr.inicio[0] == 0 && g->csr.inicio[g->csr.numVertices] == g->csr.numArestas;
+    if (ok && verificar) {
+        // Verificação completa: a soma de todos os bytes e a validade de cada índice de aresta
+        ok = somaFNV(FNV_BASE, dados + sizeof(cab), tamanho - sizeof(cab)) == cab.soma && indicesCSRValidos(&g->csr);
+    }
+    if (!ok) {
+        fecharGrafoMapeado(g);
+        return NULL;
+    }
+
+#ifndef _WIN32
+    // As consultas saltam pelo ficheiro, por isso a leitura antecipada sequencial deixa de ajudar
+    madvise(dados, tamanho, MADV_RANDOM);
+#endif
+    return g;
+#endif
+}
+
+/// @brief Abre um ficheiro binário (versão 3) sem o ler: as secções são usadas diretamente a partir do ficheiro mapeado
+/// @param nomeFicheiro Caminho do ficheiro binário
+/// @param verificar true para confirmar a soma de verificação e a coerência das arestas (percorre o ficheiro todo)
+/// @return Apontador para o grafo mapeado (usar g->csr com as funções do grafo compacto), ou NULL se o ficheiro
+///         não abrir, não estiver na versão 3 ou for inválido
+GrafoMapeado* abrirGrafoMapeado(char* nomeFicheiro, bool verificar) {
+    INICIAR_TEMPO(tempoInicio);
+    GrafoMapeado* g = mapearGrafo(nomeFicheiro, verificar);
+
+    if (g != NULL) {
+        TERMINAR_TEMPO(tempoInicio, FASE_LER);
+    }
+    return g;
+}
+
+/// @brief Fecha um grafo aberto com abrirGrafoMapeado
+/// @param g Apontador para o grafo mapeado
+void fecharGrafoMapeado(GrafoMapeado* g) {
+    if (g != NULL) {
+        desmapearFicheiro((char*)g->dados, g->tamanho);
+        free(g);
+    }
+}
+
+/// @brief Lê um ficheiro na versão 3 para um grafo compacto com vetores próprios (que pode ser libertado com libertarGrafoCSR)
+/// @param nomeFicheiro Caminho do ficheiro binário
+/// @return Apontador para o grafo compacto, ou NULL em caso de erro
+static GrafoCSR* copiarGrafoMapeado(char* nomeFicheiro) {
+    GrafoMapeado* m = mapearGrafo(nomeFicheiro, true);
+    GrafoCSR* c;
+    size_t n;
+
+    if (m == NULL) {
+        return NULL;
+    }
+    c = alocarGrafoCSR(m->csr.numVertices, m->csr.numArestas);
+    if (c != NULL) {
+        n = (size_t)m->csr.numVertices;
+        c->metrica = m->csr.metrica;
+        memcpy(c->x, m->csr.x, n * sizeof(int));
+        memcpy(c->y, m->csr.y, n * sizeof(int));
+        memcpy(c->freq, m->csr.freq, n);
+        memcpy(c->inicio, m->csr.inicio, (n + 1) * sizeof(int));
+        memcpy(c->destino, m->csr.destino, (size_t)m->csr.numArestas * sizeof(int));
+    }
+    fecharGrafoMapeado(m);
+    return c;
+}
+
+/*
+* Formato comprimido (versão 4), para ficheiros pequenos em vez de consulta no sítio:
+*   Cabeçalho:  "GRAF" | 4 | n | m | métrica | número de cliques | bytes dos vértices | bytes das arestas
+*   freq[n] | frequências com clique completo[número de cliques] | vértices | arestas
+* Os números são varints (7 bits por byte, o bit mais alto indica que o número continua), e os que podem ser
+* negativos passam por zigzag (0, -1, 1, -2... ficam 0, 1, 2, 3...). Os vértices são guardados como diferenças
+* para o vértice anterior (x, e y quando a linha é a mesma). As arestas de cada vértice são o número de arestas
+* seguido dos destinos por ordem crescente: o primeiro como diferença para o próprio vértice e os restantes como
+* diferença para o anterior, por isso destinos próximos ocupam um byte. Se todas as antenas de uma frequência
+* estiverem ligadas entre si, a frequência é marcada como clique e essas arestas não são gravadas: o leitor
+* volta a criá-las a partir da lista de membros. Depois da leitura, as arestas de cada vértice ficam por ordem
+* crescente de índice do destino.
+*/
+
+/// @brief Cabeçalho do ficheiro binário na versão 4 (começa com o cabeçalho das versões anteriores)
+typedef struct CabecalhoComprimido {
+    CabecalhoFicheiro base;             // "GRAF" | 4 | n | m
+    uint32_t metrica;                   // Métrica dos pesos (MetricaDistancia)
+    uint32_t numCliques;                // Número de frequências gravadas como clique completo
+    uint64_t bytesVertices;             // Bytes da secção de vértices
+    uint64_t bytesArestas;              // Bytes da secção de arestas
+} CabecalhoComprimido;
+
+/// @brief Vetor de bytes que cresce à medida que são acrescentados números
+typedef struct BufferBytes {
+    unsigned char* dados;
+    size_t n;
+    size_t capacidade;
+} BufferBytes;
+
+/// @brief Converte um inteiro com sinal para sem sinal, com os valores pequenos (positivos ou negativos) a ficarem pequenos
+/// @param v Valor com sinal
+/// @return Valor zigzag
+static inline uint32_t paraZigzag(int64_t v) {
+    return (uint32_t)((v < 0) ? (-v * 2 - 1) : (v * 2));
+}
+
+/// @brief Inverso de paraZigzag
+/// @param z Valor zigzag
+/// @return Valor com sinal
+static inline int64_t deZigzag(uint32_t z) {
+    return (z & 1) ? -(int64_t)(z >> 1) - 1 : (int64_t)(z >> 1);
+}
+
+/// @brief Acrescenta um número ao buffer como varint (1 a 5 bytes)
+/// @param b Apontador para o buffer
+/// @param v Número a acrescentar
+/// @return false se falhar a alocação
+static bool escreverVarint(BufferBytes* b, uint32_t v) {
+    if (b->n + 5 > b->capacidade) {
+        size_t capacidade = (b->capacidade == 0) ? 4096 : b->capacidade * 2;
+        unsigned char* novo = (unsigned char*)realloc(b->dados, capacidade);
+        if (novo == NULL) {
+            return false;
+        }
+        b->dados = novo;
+        b->capacidade = capacidade;
+    }
+    while (v >= 0x80) {
+        b->dados[b->n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    b->dados[b->n++] = (unsigned char)v;
+    return true;
+}
+
+/// @brief Lê um varint
+/// @param p Posição atual
+/// @param fim Fim dos dados
+/// @param v Apontador onde é devolvido o número
+/// @return Posição a seguir ao número, ou NULL se os dados terminarem a meio ou o número for demasiado grande
+static inline const unsigned char* lerVarint(const unsigned char* p, const unsigned char* fim, uint32_t* v) {
+    uint32_t r = 0;
+
+    // Caso mais frequente (diferenças pequenas): um só byte
+    if (p < fim && *p < 0x80) {
+        *v = *p;
+        return p + 1;
+    }
+    for (int desloc = 0; desloc < 35 && p < fim; desloc += 7) {
+        r |= (uint32_t)(*p & 0x7F) << desloc;
+        if (*p++ < 0x80) {
+            *v = r;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/// @brief Compara dois inteiros (para qsort)
+static int compararInteiros(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/// @brief Grava um grafo compacto no formato comprimido (versão 4)
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param c Apontador para o grafo compacto (não é alterado)
+/// @return true se a gravação for bem-sucedida, false em caso de erro.
+bool gravarFicheiroBinarioComprimidoCSR(char* nomeFicheiro, GrafoCSR* c) {
+    CabecalhoComprimido cab;
+    BufferBytes vertices = { NULL, 0, 0 }, arestas = { NULL, 0, 0 };
+    char cliques[256];
+    int tamanhoGrupo[256] = { 0 };
+    bool clique[256];
+    int* destino = NULL;
+    bool ok = true;
+    FILE* fp;
+    int v, k, f;
+
+    if (c == NULL) {
+        return false;
+    }
+    INICIAR_TEMPO(tempoInicio);
+
+    // Os destinos de cada vértice são ordenados numa cópia, para as diferenças serem sempre positivas
+    destino = (int*)malloc(((size_t)c->numArestas + 1) * sizeof(int));
+    if (destino == NULL) {
+        return false;
+    }
+    memcpy(destino, c->destino, (size_t)c->numArestas * sizeof(int));
+    for (v = 0; v < c->numVertices; v++) {
+        if (c->inicio[v + 1] - c->inicio[v] > 1) {
+            qsort(destino + c->inicio[v], (size_t)(c->inicio[v + 1] - c->inicio[v]), sizeof(int), compararInteiros);
+        }
+    }
+
+    // Uma frequência é clique se cada membro estiver ligado, uma vez, a cada um dos outros membros
+    for (v = 0; v < c->numVertices; v++) {
+        tamanhoGrupo[(unsigned char)c->freq[v]]++;
+    }
+    for (f = 0; f < 256; f++) {
+        clique[f] = tamanhoGrupo[f] >= 2;
+    }
+    for (v = 0; v < c->numVertices; v++) {
+        unsigned char fv = (unsigned char)c->freq[v];
+        int iguais = 0, anterior = -1;
+
+        for (k = c->inicio[v]; clique[fv] && k < c->inicio[v + 1]; k++) {
+            int d = destino[k];
+            if (d != v && (unsigned char)c->freq[d] == fv) {
+                if (d == anterior) {
+                    clique[fv] = false;     // Aresta repetida: não pode ser reconstruída a partir do clique
+                }
+                anterior = d;
+                iguais++;
+            }
+        }
+        if (iguais != tamanhoGrupo[fv] - 1) {
+            clique[fv] = false;
+        }
+    }
+
+    memcpy(cab.base.magia, FICHEIRO_MAGIA, 4);
+    cab.base.versao = FICHEIRO_VERSAO_COMPRIMIDA;
+    cab.base.numVertices = (uint32_t)c->numVertices;
+    cab.base.numArestas = (uint32_t)c->numArestas;
+    cab.metrica = (uint32_t)c->metrica;
+    cab.numCliques = 0;
+    for (f = 0; f < 256; f++) {
+        if (clique[f]) {
+            cliques[cab.numCliques++] = (char)f;
+        }
+    }
+
+    // Vértices: diferença para o anterior (y só é relativo quando a linha se mantém)
+    for (v = 0; ok && v < c->numVertices; v++) {
+        int64_t px = (v > 0) ? c->x[v - 1] : 0;
+        int64_t py = (v > 0 && c->x[v - 1] == c->x[v]) ? c->y[v - 1] : 0;
+        ok = escreverVarint(&vertices, paraZigzag(c->x[v] - px))
+          && escreverVarint(&vertices, paraZigzag(c->y[v] - py));
+    }
+
+    // Arestas: número de arestas gravadas e destinos em diferenças, sem as arestas dos cliques
+    for (v = 0; ok && v < c->numVertices; v++) {
+        unsigned char fv = (unsigned char)c->freq[v];
+        int total = 0, anterior = v;
+        bool primeiro = true;
+
+        for (k = c->inicio[v]; k < c->inicio[v + 1]; k++) {
+            int d = destino[k];
+            total += !(clique[fv] && d != v && (unsigned char)c->freq[d] == fv);
+        }
+        ok = escreverVarint(&arestas, (uint32_t)total);
+        for (k = c->inicio[v]; ok && k < c->inicio[v + 1]; k++) {
+            int d = destino[k];
+            if (clique[fv] && d != v && (unsigned char)c->freq[d] == fv) {
+                continue;
+            }
+            ok = escreverVarint(&arestas, primeiro ? paraZigzag((int64_t)d - v) : (uint32_t)(d - anterior));
+            anterior = d;
+            primeiro = false;
+        }
+    }
+    free(destino);
+
+    cab.bytesVertices = vertices.n;
+    cab.bytesArestas = arestas.n;
+    fp = ok ? fopen(nomeFicheiro, "wb") : NULL;
+    if (fp != NULL) {
+        ok = fwrite(&cab, sizeof(cab), 1, fp) == 1
+          && fwrite(c->freq, 1, (size_t)c->numVertices, fp) == (size_t)c->numVertices
+          && fwrite(cliques, 1, cab.numCliques, fp) == cab.numCliques
+          && fwrite(vertices.dados, 1, vertices.n, fp) == vertices.n
+          && fwrite(arestas.dados, 1, arestas.n, fp) == arestas.n;
+        CONTAR(bytesEscritos, ftell(fp));
+        if (fclose(fp) != 0) {
+            ok = false;
+        }
+    } else {
+        ok = false;
+    }
+
+    free(vertices.dados);
+    free(arestas.dados);
+    if (ok) {
+        TERMINAR_TEMPO(tempoInicio, FASE_GRAVAR);
+    }
+    return ok;
+}
+
+/// @brief Grava o grafo no formato comprimido (versão 4): ficheiros mais pequenos, sobretudo com cliques grandes
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param g Apontador para o grafo
+/// @return true se a gravação for bem-sucedida, false em caso de erro.
+bool gravarFicheiroBinarioComprimido(char* nomeFicheiro, Grafo* g) {
+    GrafoCSR* c = congelarGrafo(g);
+    bool ok = gravarFicheiroBinarioComprimidoCSR(nomeFicheiro, c);
+
+    libertarGrafoCSR(c);
+    return ok;
+}
+
+/// @brief Lê as secções do formato comprimido (o cabeçalho base já foi lido) para um grafo compacto
+/// @param fp Ficheiro aberto, posicionado depois do cabeçalho base
+/// @param base Cabeçalho base lido
+/// @return Apontador para o grafo compacto, ou NULL em caso de erro
+static GrafoCSR* lerSeccoesComprimidas(FILE* fp, CabecalhoFicheiro* base) {
+    CabecalhoComprimido cab;
+    const size_t resto = sizeof(cab) - sizeof(cab.base);
+    unsigned char* dados = NULL;
+    const unsigned char *p, *fim;
+    int inicioFreq[257] = { 0 };
+    int* membros = NULL;
+    bool clique[256] = { false };
+    GrafoCSR* c = NULL;
+    size_t tamanho;
+    long atual;
+    uint32_t valor = 0;
+    int64_t px = 0, py = 0;
+    int n, m, v, pos = 0;
+    bool ok;
+
+    cab.base = *base;
+    if (fread((char*)&cab + sizeof(cab.base), 1, resto, fp) != resto
+        || cab.base.numVertices > INT32_MAX || cab.base.numArestas > INT32_MAX || cab.metrica > DISTANCIA_EUCLIDIANA
+        || cab.numCliques > 256 || cab.bytesVertices > SIZE_MAX / 2 || cab.bytesArestas > SIZE_MAX / 2) {
+        return NULL;
+    }
+    n = (int)cab.base.numVertices;
+    m = (int)cab.base.numArestas;
+
+    // O resto do ficheiro é lido de uma vez e descodificado em memória; o tamanho tem de bater certo com o cabeçalho
+    tamanho = (size_t)n + cab.numCliques + (size_t)cab.bytesVertices + (size_t)cab.bytesArestas;
+    atual = ftell(fp);
+    if (atual < 0 || fseek(fp, 0, SEEK_END) != 0 || (uint64_t)(ftell(fp) - atual) != tamanho
+        || fseek(fp, atual, SEEK_SET) != 0) {
+        return NULL;
+    }
+    dados = (unsigned char*)malloc(tamanho + 1);
+    c = alocarGrafoCSR(n, m);
+    membros = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    ok = dados != NULL && c != NULL && membros != NULL && fread(dados, 1, tamanho, fp) == tamanho;
+
+    if (ok) {
+        c->metrica = (MetricaDistancia)cab.metrica;
+        memcpy(c->freq, dados, (size_t)n);
+        for (uint32_t i = 0; i < cab.numCliques; i++) {
+            clique[dados[n + i]] = true;
+        }
+
+        // Membros de cada frequência por ordem crescente de índice (contagem por frequência)
+        for (v = 0; v < n; v++) {
+            inicioFreq[(unsigned char)c->freq[v] + 1]++;
+        }
+        for (int f = 0; f < 256; f++) {
+            inicioFreq[f + 1] += inicioFreq[f];
+        }
+        int proximo[256];
+        memcpy(proximo, inicioFreq, sizeof(proximo));
+        for (v = 0; v < n; v++) {
+            membros[proximo[(unsigned char)c->freq[v]]++] = v;
+        }
+    }
+
+    // Vértices
+    p = dados + (ok ? (size_t)n + cab.numCliques : 0);
+    fim = p + (ok ? cab.bytesVertices : 0);
+    for (v = 0; ok && v < n; v++) {
+        int64_t x, y;
+        // Cada valor só é descodificado depois de ser lido com sucesso
+        ok = (p = lerVarint(p, fim, &valor)) != NULL;
+        if (!ok) {
+            break;
+        }
+        x = px + deZigzag(valor);
+        ok = (p = lerVarint(p, fim, &valor)) != NULL;
+        if (!ok) {
+            break;
+        }
+        y = ((v > 0 && x == px) ? py : 0) + deZigzag(valor);
+        ok = x >= INT32_MIN && x <= INT32_MAX && y >= INT32_MIN && y <= INT32_MAX;
+        c->x[v] = (int)x;
+        c->y[v] = (int)y;
+        px = x;
+        py = y;
+    }
+    ok = ok && p == fim;
+
+    // Arestas: as gravadas são juntas, por ordem crescente, com os membros do clique da frequência do vértice
+    fim = p + (ok ? cab.bytesArestas : 0);
+    for (v = 0; ok && v < n; v++) {
+        unsigned char fv = (unsigned char)c->freq[v];
+        int j = clique[fv] ? inicioFreq[fv] : 0, fimClique = clique[fv] ? inicioFreq[fv + 1] : 0;
+        int64_t d = v;
+        uint32_t total = 0;
+
+        c->inicio[v] = pos;
+        ok = (p = lerVarint(p, fim, &total)) != NULL;
+        for (uint32_t k = 0; ok && k <= total; k++) {
+            if (k < total) {
+                ok = (p = lerVarint(p, fim, &valor)) != NULL;
+                if (!ok) {
+                    break;
+                }
+                d = (k == 0) ? v + deZigzag(valor) : d + valor;
+                ok = d >= 0 && d < n;
+            } else {
+                d = n;          // Depois da última aresta gravada, copia os membros do clique que faltam
+            }
+            for (; ok && j < fimClique && membros[j] < d; j++) {
+                if (membros[j] != v) {
+                    ok = pos < m;
+                    c->destino[pos++] = membros[j];
+                }
+            }
+            if (ok && k < total) {
+                ok = pos < m;
+                c->destino[pos++] = (int)d;
+            }
+        }
+    }
+    ok = ok && p == fim && pos == m;
+    if (ok) {
+        c->inicio[n] = m;
+    }
+
+    free(dados);
+    free(membros);
+    if (!ok) {
+        libertarGrafoCSR(c);
+        return NULL;
+    }
+    return c;
+}
+
+/// @brief Lê o formato antigo (sem cabeçalho): para cada antena, frequência, coordenadas, número de adjacências
+///        e a frequência e coordenadas de cada adjacência. As arestas só são criadas depois de todos os vértices
+///        estarem lidos, para não se perderem as que apontam para vértices mais à frente no ficheiro.
+/// @param fp Ficheiro aberto no início
+/// @param g Grafo vazio onde são inseridos os vértices e as arestas
+/// @return true se a leitura for bem sucedida
+static bool lerFicheiroBinarioAntigo(FILE* fp, Grafo* g) {
+    char freq;
+    int32_t x, y, n;
+    Vertice* nova;
+    int32_t* pendentes = NULL;      // Triplos (origem, x, y) das arestas por resolver
+    char* freqsPendentes = NULL;
+    size_t numPendentes = 0, capacidade = 0;
+    bool ok = true;
+
+    // Lê os dados enquanto houver informação no ficheiro
+    while (ok && fread(&freq, sizeof(char), 1, fp) == 1 &&
+           fread(&x, sizeof(int32_t), 1, fp) == 1 &&
+           fread(&y, sizeof(int32_t), 1, fp) == 1 &&
+           fread(&n, sizeof(int32_t), 1, fp) == 1) {
+
+        nova = inserirAntenaGrafo(g, freq, x, y);
+        if (nova == NULL || n < 0) {
+            ok = false;
+            break;
+        }
+
+        // Guarda as adjacências para as resolver no fim
+        for (int32_t i = 0; i < n; i++) {
+            char fAdj;
+            int32_t xAdj, yAdj;
+            if (fread(&fAdj, sizeof(char), 1, fp) != 1 ||
+                fread(&xAdj, sizeof(int32_t), 1, fp) != 1 ||
+                fread(&yAdj, sizeof(int32_t), 1, fp) != 1) {
+                ok = false;
+                break;
+            }
+            if (numPendentes == capacidade) {
+                capacidade = (capacidade == 0) ? 64 : capacidade * 2;
+                int32_t* p = (int32_t*)realloc(pendentes, capacidade * 3 * sizeof(int32_t));
+                char* f = (char*)realloc(freqsPendentes, capacidade);
+                if (p) pendentes = p;
+                if (f) freqsPendentes = f;
+                if (!p || !f) {
+                    ok = false;
+                    break;
+                }
+            }
+            pendentes[numPendentes * 3] = nova->id;
+            pendentes[numPendentes * 3 + 1] = xAdj;
+            pendentes[numPendentes * 3 + 2] = yAdj;
+            freqsPendentes[numPendentes] = fAdj;
+            numPendentes++;
+        }
+    }
+
+    // Resolve cada aresta através do índice de coordenadas e insere-a pela ordem original
+    for (size_t i = numPendentes; ok && i-- > 0; ) {
+        Vertice* origem = g->vertices[pendentes[i * 3]];
+        Vertice* destino = procurarAntenaGrafo(g, freqsPendentes[i], pendentes[i * 3 + 1], pendentes[i * 3 + 2]);
+        if (destino != NULL) {
+            Aresta* novaAdj = criarAdjacenciaGrafo(g, origem, destino);
+            if (novaAdj != NULL) {
+                inserirAdjacencia(origem, novaAdj);
+            }
+        }
+    }
+
+    free(pendentes);
+    free(freqsPendentes);
+    return ok;
+}
+
+/// @brief Lê as secções do formato com cabeçalho (o cabeçalho já foi lido) para um grafo compacto
+/// @param fp Ficheiro aberto, posicionado depois do cabeçalho
+/// @param cab Cabeçalho lido
+/// @return Apontador para o grafo compacto, ou NULL em caso de erro
+static GrafoCSR* lerSeccoesCSR(FILE* fp, CabecalhoFicheiro* cab) {
+    uint32_t n = cab->numVertices, m = cab->numArestas;
+    GrafoCSR* c;
+    bool ok;
+
+    if (cab->versao != FICHEIRO_VERSAO || n > INT32_MAX || m > INT32_MAX) {
+        return NULL;
+    }
+
+    c = alocarGrafoCSR((int)n, (int)m);
+    if (c == NULL) {
+        return NULL;
+    }
+
+    // Cada secção é lida com uma única leitura, diretamente para os vetores do grafo compacto
+    ok = fread(c->x, sizeof(int32_t), n, fp) == n
+      && fread(c->y, sizeof(int32_t), n, fp) == n
+      && fread(c->freq, 1, n, fp) == n
+      && fread(c->inicio, sizeof(int32_t), n + 1, fp) == n + 1
+      && fread(c->destino, sizeof(int32_t), m, fp) == m;
+
+    // A versão 2 não tem soma de verificação: os índices são sempre verificados antes de o grafo ser usado
+    ok = ok && indicesCSRValidos(c);
+    if (!ok) {
+        libertarGrafoCSR(c);
+        return NULL;
+    }
+    return c;
+}
+
+/// @brief Lê as secções de um ficheiro com cabeçalho (já lido) de acordo com a sua versão
+/// @param nomeFicheiro Caminho do ficheiro (a versão 3 é mapeada em vez de lida)
+/// @param fp Ficheiro aberto, posicionado depois do cabeçalho
+/// @param cab Cabeçalho lido
+/// @return Apontador para o grafo compacto, ou NULL em caso de erro
+static GrafoCSR* lerSeccoesVersao(char* nomeFicheiro, FILE* fp, CabecalhoFicheiro* cab) {
+    switch (cab->versao) {
+        case FICHEIRO_VERSAO_MAPEAVEL:
+            return copiarGrafoMapeado(nomeFicheiro);
+        case FICHEIRO_VERSAO_COMPRIMIDA:
+            return lerSeccoesComprimidas(fp, cab);
+        default:
+            return lerSeccoesCSR(fp, cab);
+    }
+}
+
+/// @brief Lê o ficheiro binário diretamente para um grafo compacto, sem criar nós
+/// @param nomeFicheiro Caminho do ficheiro binário
+/// @param res Apontador para flag de sucesso
+/// @return Apontador para o grafo compacto, ou NULL em caso de erro (ou se o ficheiro estiver no formato antigo)
+GrafoCSR* lerFicheiroBinarioCSR(char* nomeFicheiro, bool *res) {
+    CabecalhoFicheiro cab;
+    GrafoCSR* c = NULL;
+    INICIAR_TEMPO(tempoInicio);
+    FILE* fp = fopen(nomeFicheiro, "rb");
+
+    *res = false;
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    if (fread(&cab, sizeof(cab), 1, fp) == 1 && memcmp(cab.magia, FICHEIRO_MAGIA, 4) == 0) {
+        c = lerSeccoesVersao(nomeFicheiro, fp, &cab);
+    }
+    CONTAR(bytesLidos, ftell(fp));
+    fclose(fp);
+
+    *res = (c != NULL);
+    if (*res) {
+        TERMINAR_TEMPO(tempoInicio, FASE_LER);
+    }
+    return c;
+}
+
+/// @brief Lê um ficheiro binário e reconstrói o grafo com as antenas e respetivas adjacências
+/// @param nomeFicheiro Nome do ficheiro binário a abrir
+/// @param res Apontador para um booleano que indica se a leitura foi bem sucedida
+/// @return Devolve o grafo reconstruído, ou NULL em caso de erro
+Grafo* lerFicheiroBinario (char* nomeFicheiro, bool *res) {
+    CabecalhoFicheiro cab;
+    Grafo* g;
+    bool ok;
+
+    *res = false;
+    INICIAR_TEMPO(tempoInicio);
+
+    // Abre o ficheiro em modo leitura binária
+    FILE* fp = fopen(nomeFicheiro, "rb");
+
+    // Se não abrir o ficheiro corretamente devolve null
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    g = criarGrafo();
+    if (g == NULL) {
+        fclose(fp);
+        return NULL;
+    }
+
+    if (fread(&cab, sizeof(cab), 1, fp) == 1 && memcmp(cab.magia, FICHEIRO_MAGIA, 4) == 0) {
+        // Lê as secções para um grafo compacto e cria os nós a partir dele numa só passagem
+        GrafoCSR* c = lerSeccoesVersao(nomeFicheiro, fp, &cab);
+        libertarGrafo(g);
+        g = criarGrafoDeCSR(c);
+        ok = (g != NULL);
+        libertarGrafoCSR(c);
+    } else {
+        // Sem o cabeçalho, o ficheiro está no formato antigo
+        rewind(fp);
+        ok = lerFicheiroBinarioAntigo(fp, g);
+    }
+
+    // Fecha o ficheiro e atualiza o resultado
+    CONTAR(bytesLidos, ftell(fp));
+    fclose(fp);
+    if (!ok) {
+        libertarGrafo(g);
+        return NULL;
+    }
+    *res = true;
+    TERMINAR_TEMPO(tempoInicio, FASE_LER);
+    return g;
 }
 
 #pragma endregion
\ No newline at end of file
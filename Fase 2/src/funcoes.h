@@ -10,7 +10,10 @@
 
 #ifndef FUNCOES_H
 #define FUNCOES_H  
+#include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #pragma region Estrutura de Dados
 /// @brief Representa uma antena como vértice do grafo
@@ -18,10 +21,19 @@ typedef struct Vertice {
     char freq;                  //Frequência da antena (A até Z)
     int x, y;                   //Coordenadas da antena
     int visitado;               // Indica se a antena já foi visitada (0 = não visitado, 1 = visitado)
+    int id;                     //Índice do vértice no grafo (0 até numVertices-1), -1 se não pertencer a um grafo
+    int posMembros;             //Posição do vértice na lista de membros da sua frequência
     struct Vertice* prox;       //Próximo vértice (antena) na lista
+    struct Vertice* ant;        //Vértice anterior na lista (mantido pelas funções do grafo)
     struct Aresta* adj;         //Lista ligada de arestas (ligações)
 } Vertice;
 
+/// @brief Métrica usada para o peso das arestas (distância entre as coordenadas das duas antenas)
+typedef enum MetricaDistancia {
+    DISTANCIA_MANHATTAN,        //|dx| + |dy|
+    DISTANCIA_EUCLIDIANA        //sqrt(dx² + dy²), arredondada para cima
+} MetricaDistancia;
+
 /// @brief Representa uma aresta (ligação) entre duas antenas do grafo
 typedef struct Aresta { 
     int peso;                   //Distância entre coordenadas
@@ -29,12 +41,198 @@ typedef struct Aresta {
     struct Aresta* prox;        //Próxima aresta na lista de adjacência
 } Aresta;
 
+/// @brief Entrada do índice de coordenadas: posição (x, y) e o vértice que lá está
+typedef struct EntradaIndice {
+    int x, y;                   //Coordenadas da antena
+    Vertice* v;                 //Vértice (NULL se a entrada estiver livre)
+} EntradaIndice;
+
+/// @brief Tabela de hash com endereçamento aberto que associa cada posição (x, y) ao seu vértice
+typedef struct IndiceCoordenadas {
+    EntradaIndice* entradas;    //Vetor de entradas
+    int capacidade;             //Número de entradas (potência de 2)
+    int ocupadas;               //Entradas com um vértice
+    int apagadas;               //Entradas marcadas como removidas
+} IndiceCoordenadas;
+
+/// @brief Bloco de memória de uma pool; os elementos ficam a seguir a este cabeçalho
+typedef struct BlocoPool {
+    struct BlocoPool* prox;     //Bloco seguinte
+} BlocoPool;
+
+/// @brief Pool de nós com o mesmo tamanho, entregues a partir de blocos contíguos e reaproveitados por uma lista de livres
+typedef struct Pool {
+    size_t tamanho;             //Tamanho de cada elemento (arredondado ao alinhamento)
+    int porBloco;               //Número de elementos do próximo bloco a alocar
+    BlocoPool* blocos;          //Lista dos blocos alocados
+    char* proximo;              //Próximo elemento por usar no bloco atual
+    int restantes;              //Elementos por usar no bloco atual
+    void* livres;               //Lista de elementos devolvidos, prontos a reutilizar
+    long emUso;                 //Elementos entregues e ainda não devolvidos
+    long pedidos;               //Total de pedidos de elementos
+    long reutilizados;          //Pedidos servidos pela lista de livres
+    int numBlocos;              //Número de blocos alocados
+    size_t bytes;               //Total de bytes alocados em blocos
+} Pool;
+
+/// @brief Lista dos vértices de uma frequência (vetor, sem ordem definida)
+typedef struct MembrosFrequencia {
+    int n;                      //Número de vértices da frequência
+    int capacidade;             //Número de posições alocadas
+    Vertice** v;                //Vértices da frequência
+} MembrosFrequencia;
+
+#define NUM_FREQUENCIAS 256
+
+/// @brief Componentes ligadas do grafo numa estrutura union-find (floresta de conjuntos disjuntos), indexada pelo id dos vértices
+typedef struct Componentes {
+    int* pai;                   //Pai de cada id na floresta (a raiz é o representante da componente)
+    int* rank;                  //Limite superior da altura da árvore de cada raiz
+    int* tamanho;               //Número de vértices da componente (válido nas raízes)
+    int capacidade;             //Número de posições alocadas
+    int numComponentes;         //Número de componentes
+    bool valido;                //false depois de uma remoção: a estrutura é reconstruída na próxima consulta
+} Componentes;
+
+/// @brief Célula da grelha espacial: os vértices de uma parte (todas as frequências ou uma só) numa área lado x lado
+typedef struct CelulaEspacial {
+    bool usada;                 //Se false, a posição da tabela está livre
+    int parte;                  //0 = todas as frequências, 1 + freq = só essa frequência
+    int cx, cy;                 //Coordenadas da célula (coordenada da antena dividida pelo lado, arredondada para baixo)
+    int n;                      //Número de vértices na célula
+    int capacidade;             //Número de posições alocadas
+    Vertice** v;                //Vértices da célula
+} CelulaEspacial;
+
+/// @brief Índice espacial do grafo: grelha uniforme de células guardadas numa tabela de hash (só as células ocupadas existem)
+typedef struct IndiceEspacial {
+    int lado;                   //Lado de cada célula
+    CelulaEspacial* celulas;    //Tabela de células (endereçamento aberto)
+    int capacidade;             //Número de posições da tabela (potência de 2)
+    int ocupadas;               //Células criadas (as células vazias não são apagadas)
+    int minCx, maxCx;           //Limites das células criadas
+    int minCy, maxCy;
+    bool valido;                //false se uma inserção falhou: a grelha é reconstruída na próxima consulta
+} IndiceEspacial;
+
 /// @brief Representa o grafo, contendo a lista de antenas (vértices) e o número total de antenas
 typedef struct Grafo {
     Vertice* h;                 //Apontador para o ínicio da lista de antenas
     int numVertices;            //Número total de antenas do grafo
+    Vertice* cauda;             //Último vértice da lista
+    Vertice** vertices;         //Vértices indexados pelo seu id
+    int capacidadeVertices;     //Número de posições alocadas em vertices
+    IndiceCoordenadas indice;   //Índice (x, y) -> vértice, mantido pelas funções do grafo
+    MembrosFrequencia membros[NUM_FREQUENCIAS]; //Vértices de cada frequência, mantidos pelas funções do grafo
+    bool cliquesImplicitos;     //Se true, as antenas com a mesma frequência estão ligadas sem arestas guardadas
+    Pool poolVertices;          //Memória dos vértices do grafo
+    Pool poolArestas;           //Memória das arestas do grafo
+    MetricaDistancia metrica;   //Métrica do peso das arestas (DISTANCIA_MANHATTAN por omissão)
+    Componentes componentes;    //Componentes ligadas, mantidas ao inserir vértices e arestas
+    IndiceEspacial* espacial;   //Índice espacial (NULL até à primeira consulta), mantido ao inserir e remover vértices
 } Grafo;
 
+/// @brief Iterador sobre os vizinhos de um vértice: arestas guardadas e, no modo implícito, os membros da mesma frequência
+typedef struct IteradorVizinhos {
+    Grafo* g;                   //Grafo do vértice
+    Vertice* v;                 //Vértice cujos vizinhos são percorridos
+    Aresta* aresta;             //Próxima aresta guardada a ver
+    int pos;                    //Próxima posição a ver na lista de membros da frequência
+    bool semMembros;            //Se true, os membros da frequência não são percorridos
+    int peso;                   //Peso da ligação devolvida pela última chamada a proximoVizinho
+} IteradorVizinhos;
+
+/// @brief Representação compacta (CSR) e só de leitura de um grafo: vetores contíguos em vez de nós ligados
+typedef struct GrafoCSR {
+    int numVertices;            //Número de vértices
+    int numArestas;             //Número de arestas
+    char* freq;                 //Frequência de cada vértice
+    int* x;                     //Coordenada X de cada vértice
+    int* y;                     //Coordenada Y de cada vértice
+    int* inicio;                //As arestas do vértice v são destino[inicio[v]] até destino[inicio[v+1]-1]
+    int* destino;               //Índice do vértice de destino de cada aresta
+    MetricaDistancia metrica;   //Métrica dos pesos do grafo de origem (gravada no ficheiro binário)
+} GrafoCSR;
+
+/// @brief Grafo compacto aberto diretamente de um ficheiro binário mapeado em memória (só de leitura)
+typedef struct GrafoMapeado {
+    GrafoCSR csr;               //Os vetores apontam para as secções do ficheiro (não usar libertarGrafoCSR)
+    void* dados;                //Início do ficheiro mapeado
+    size_t tamanho;             //Número de bytes do ficheiro
+} GrafoMapeado;
+
+/// @brief Função chamada pelos percursos para cada vértice descoberto
+/// @param v Vértice descoberto
+/// @param profundidade Profundidade na pilha (DFS) ou distância em arestas à origem (BFS)
+/// @param contexto Apontador dado ao percurso
+/// @return true para continuar o percurso, false para o terminar
+typedef bool (*VisitarVertice)(Vertice* v, int profundidade, void* contexto);
+
+/// @brief Fases da biblioteca cujo tempo é medido pela instrumentação
+typedef enum FaseEstatistica {
+    FASE_CARREGAR,              //criarGrafoDeFicheiro
+    FASE_ADJACENCIAS,           //ligarFrequenciasGrafo
+    FASE_PERCURSOS,             //percursoProfundidade e percursoLargura
+    FASE_CAMINHOS,              //Dijkstra e A*
+    FASE_CONGELAR,              //congelarGrafo
+    FASE_GRAVAR,                //gravarFicheiroBinarioCSR e gravarFicheiroBinarioComprimidoCSR (e as versões com Grafo)
+    FASE_LER,                   //lerFicheiroBinario e lerFicheiroBinarioCSR
+    NUM_FASES_ESTATISTICA
+} FaseEstatistica;
+
+/// @brief Contadores da instrumentação (só são atualizados se a biblioteca for compilada com EDA_ESTATISTICAS)
+typedef struct Estatisticas {
+    long alocacoes;                             //Vértices e arestas pedidos (malloc ou pool)
+    long passosLista;                           //Nós percorridos nas listas ordenadas (inserirAntena, procurarAntena, removerAntena, inserirAntenaGrafo)
+    long arestasCriadas;                        //Arestas criadas
+    long bytesLidos;                            //Bytes lidos dos ficheiros (mapa de texto e ficheiros binários)
+    long bytesEscritos;                         //Bytes escritos nos ficheiros binários
+    long chamadas[NUM_FASES_ESTATISTICA];       //Chamadas concluídas de cada fase
+    double segundos[NUM_FASES_ESTATISTICA];     //Tempo total de cada fase (relógio monotónico)
+} Estatisticas;
+
+#pragma endregion
+
+#pragma region Estatísticas
+
+/// @brief Devolve o instante atual de um relógio que nunca anda para trás (o mesmo da instrumentação, também usado pelo bench)
+/// @return Número de segundos desde um instante fixo
+double tempoMonotonico(void);
+
+/// @brief Copia o estado atual dos contadores da instrumentação
+/// @param e Apontador onde é copiado o estado (tudo a zero sem EDA_ESTATISTICAS)
+void obterEstatisticas(Estatisticas* e);
+
+/// @brief Põe todos os contadores e tempos da instrumentação a zero
+void reiniciarEstatisticas(void);
+
+/// @brief Escreve os contadores e os tempos de cada fase, um valor por linha no formato "nome: valor"
+/// @param fp Ficheiro de saída (por exemplo stderr)
+void mostrarEstatisticas(FILE* fp);
+
+#pragma endregion
+
+#pragma region Memória
+
+/// @brief Prepara uma pool vazia (nenhum bloco é alocado até ao primeiro pedido)
+/// @param p Apontador para a pool
+/// @param tamanho Tamanho de cada elemento em bytes
+void iniciarPool(Pool* p, size_t tamanho);
+
+/// @brief Entrega um elemento da pool: primeiro da lista de livres, depois do bloco atual, alocando um bloco novo se preciso
+/// @param p Apontador para a pool
+/// @return Apontador para o elemento (sem inicializar), ou NULL se falhar a alocação
+void* alocarPool(Pool* p);
+
+/// @brief Devolve um elemento à pool, para ser reutilizado
+/// @param p Apontador para a pool
+/// @param elemento Elemento entregue antes por alocarPool (pode ser NULL)
+void devolverPool(Pool* p, void* elemento);
+
+/// @brief Liberta todos os blocos da pool de uma só vez, em O(número de blocos)
+/// @param p Apontador para a pool
+void destruirPool(Pool* p);
+
 #pragma endregion
 
 #pragma region Antenas
@@ -82,7 +280,14 @@ bool resetVisitado(Vertice* h);
 
 #pragma region Adjacências
 
-/// @brief Cria uma nova ligação (aresta) entre dois vértices com a mesma frequência
+/// @brief Calcula o peso de uma ligação: a distância entre as coordenadas das duas antenas
+/// @param metrica Métrica a usar
+/// @param a Primeira antena
+/// @param b Segunda antena
+/// @return Distância de Manhattan, ou distância euclidiana arredondada para cima
+int calcularPeso(MetricaDistancia metrica, Vertice* a, Vertice* b);
+
+/// @brief Cria uma nova ligação (aresta) entre dois vértices com a mesma frequência, com o peso pela distância de Manhattan
 /// @param origem Vértice de origem da ligação
 /// @param destino Vértice de destino da ligação
 /// @return Apontador para a nova aresta criada, ou NULL se as frequências forem diferentes ou falhar a alocação
@@ -106,13 +311,275 @@ int contarAdjacencias(Vertice* v);
 
 #pragma endregion
 
+#pragma region Grafo
+
+/// @brief Cria um grafo vazio, com o índice de coordenadas inicializado
+/// @return Apontador para o novo grafo, ou NULL se falhar a alocação
+Grafo* criarGrafo(void);
+
+/// @brief Cria uma antena e insere-a no grafo, na lista ordenada e no índice de coordenadas
+/// @param g Apontador para o grafo
+/// @param freq Frequência da antena
+/// @param x Coordenada X da antena
+/// @param y Coordenada Y da antena
+/// @return Apontador para o vértice criado, ou NULL se a posição já estiver ocupada ou falhar a alocação
+Vertice* inserirAntenaGrafo(Grafo* g, char freq, int x, int y);
+
+/// @brief Procura uma antena no grafo através do índice de coordenadas, em O(1) em média
+/// @param g Apontador para o grafo
+/// @param freq Frequência a procurar
+/// @param x Coordenada X
+/// @param y Coordenada Y
+/// @return Apontador para o vértice encontrado ou NULL se não existir
+Vertice* procurarAntenaGrafo(Grafo* g, char freq, int x, int y);
+
+/// @brief Remove uma antena do grafo, com as suas arestas e as arestas de volta (uma por cada aresta de saída, como as cria ligarAntenasGrafo)
+/// @param g Apontador para o grafo
+/// @param x Coordenada X da antena a remover
+/// @param y Coordenada Y da antena a remover
+/// @return true se a antena foi removida, false se não existir
+bool removerAntenaGrafo(Grafo* g, int x, int y);
+
+/// @brief Cria uma aresta com a memória do grafo (as arestas dos vértices de um grafo devem ser criadas assim, e não com criarAdjacencia),
+///        com o peso pela métrica do grafo
+/// @param g Apontador para o grafo
+/// @param origem Vértice de origem da ligação
+/// @param destino Vértice de destino da ligação
+/// @return Apontador para a nova aresta (ainda por inserir), ou NULL se as frequências forem diferentes ou falhar a alocação
+Aresta* criarAdjacenciaGrafo(Grafo* g, Vertice* origem, Vertice* destino);
+
+/// @brief Liga duas antenas do grafo com uma aresta em cada sentido
+/// @param g Apontador para o grafo
+/// @param a Primeira antena
+/// @param b Segunda antena
+/// @return true se as arestas foram criadas, false se as frequências forem diferentes ou falhar a alocação
+bool ligarAntenasGrafo(Grafo* g, Vertice* a, Vertice* b);
+
+/// @brief Muda a métrica do grafo e recalcula o peso de todas as arestas guardadas
+/// @param g Apontador para o grafo
+/// @param metrica Nova métrica
+void definirMetricaGrafo(Grafo* g, MetricaDistancia metrica);
+
+/// @brief Liga todas as antenas com a mesma frequência, usando as listas de membros de cada frequência
+/// @param g Apontador para o grafo
+/// @param implicito Se true, não cria arestas: as ligações passam a ser produzidas pelo iterador de vizinhos (memória O(V));
+///                  se false, cria as arestas nos dois sentidos para cada par (k² arestas por frequência com k antenas)
+/// @return true se conseguiu, false se o grafo for inválido ou falhar a alocação
+bool ligarFrequenciasGrafo(Grafo* g, bool implicito);
+
+/// @brief Prepara um iterador sobre os vizinhos de um vértice
+/// @param g Apontador para o grafo
+/// @param v Vértice cujos vizinhos se querem percorrer
+/// @param it Iterador a preparar
+void iniciarVizinhos(Grafo* g, Vertice* v, IteradorVizinhos* it);
+
+/// @brief Devolve o próximo vizinho do iterador (o peso da ligação fica em it->peso)
+/// @param it Iterador preparado com iniciarVizinhos
+/// @return Próximo vértice vizinho, ou NULL se já não houver mais
+Vertice* proximoVizinho(IteradorVizinhos* it);
+
+/// @brief Conta os vizinhos de um vértice, incluindo as ligações implícitas
+/// @param g Apontador para o grafo
+/// @param v Vértice a analisar
+/// @return Número de vizinhos
+int grauGrafo(Grafo* g, Vertice* v);
+
+/// @brief Liberta toda a memória do grafo (vértices, arestas e índice), bloco a bloco sem percorrer os nós
+/// @param g Apontador para o grafo
+void libertarGrafo(Grafo* g);
+
+#pragma endregion
+
+#pragma region Índice Espacial
+
+/// @brief Cria (ou recria) o índice espacial do grafo; a partir daí é mantido a cada inserção e remoção
+/// @param g Apontador para o grafo
+/// @param lado Lado de cada célula da grelha (0 ou negativo para o valor por omissão)
+/// @return true se conseguiu, false se falhar a alocação
+bool ativarIndiceEspacial(Grafo* g, int lado);
+
+/// @brief Liberta o índice espacial do grafo (as inserções e remoções deixam de o manter)
+/// @param g Apontador para o grafo
+void desativarIndiceEspacial(Grafo* g);
+
+/// @brief Procura as antenas dentro de um retângulo (limites incluídos)
+/// @param g Apontador para o grafo
+/// @param x1 Coordenada X de um canto
+/// @param y1 Coordenada Y de um canto
+/// @param x2 Coordenada X do canto oposto
+/// @param y2 Coordenada Y do canto oposto
+/// @param freq Frequência das antenas a procurar (0 para todas)
+/// @param resultado Vetor onde são escritas as antenas encontradas (pode ser NULL)
+/// @param max Número máximo de antenas a escrever em resultado
+/// @return Número total de antenas no retângulo, ou -1 se falhar a alocação
+int antenasNoRetangulo(Grafo* g, int x1, int y1, int x2, int y2, char freq, Vertice** resultado, int max);
+
+/// @brief Procura as antenas a uma distância euclidiana de (x, y) não superior a raio
+/// @param g Apontador para o grafo
+/// @param x Coordenada X do centro
+/// @param y Coordenada Y do centro
+/// @param raio Raio da procura
+/// @param freq Frequência das antenas a procurar (0 para todas)
+/// @param resultado Vetor onde são escritas as antenas encontradas (pode ser NULL)
+/// @param max Número máximo de antenas a escrever em resultado
+/// @return Número total de antenas no círculo, ou -1 se falhar a alocação
+int antenasNoRaio(Grafo* g, int x, int y, int raio, char freq, Vertice** resultado, int max);
+
+/// @brief Procura as k antenas mais próximas de (x, y) (distância euclidiana; empates desfeitos pelas coordenadas)
+/// @param g Apontador para o grafo
+/// @param x Coordenada X do ponto
+/// @param y Coordenada Y do ponto
+/// @param k Número de antenas a procurar
+/// @param freq Frequência das antenas a procurar (0 para todas)
+/// @param resultado Vetor com k posições onde são escritas as antenas, da mais próxima para a mais afastada
+/// @return Número de antenas escritas (menos de k se não houver antenas suficientes), ou -1 se falhar a alocação
+int antenasMaisProximas(Grafo* g, int x, int y, int k, char freq, Vertice** resultado);
+
+#pragma endregion
+
+#pragma region Componentes
+
+/// @brief Atribui a cada vértice o número da sua componente ligada, em tempo quase linear (union-find)
+/// @param g Apontador para o grafo
+/// @param rotulo Vetor indexado pelo id (numVertices posições) onde fica o número da componente (0 até ao total - 1); pode ser NULL
+/// @return Número de componentes, ou -1 se falhar a alocação
+int rotularComponentes(Grafo* g, int* rotulo);
+
+/// @brief Devolve o número de componentes ligadas do grafo
+/// @param g Apontador para o grafo
+/// @return Número de componentes, ou -1 se falhar a alocação
+int contarComponentes(Grafo* g);
+
+/// @brief Devolve o número de vértices da componente de uma antena
+/// @param g Apontador para o grafo
+/// @param v Vértice do grafo
+/// @return Tamanho da componente, ou -1 se o vértice for inválido ou falhar a alocação
+int tamanhoComponente(Grafo* g, Vertice* v);
+
+/// @brief Verifica se duas antenas estão na mesma componente ligada
+/// @param g Apontador para o grafo
+/// @param a Primeira antena
+/// @param b Segunda antena
+/// @return true se existir um caminho entre as duas
+bool mesmaComponente(Grafo* g, Vertice* a, Vertice* b);
+
+#pragma endregion
+
+#pragma region Grafo Compacto
+
+/// @brief Cria a representação compacta (CSR) de um grafo, com os vértices pela ordem da lista
+/// @param g Apontador para o grafo
+/// @return Apontador para o grafo compacto, ou NULL se falhar a alocação
+GrafoCSR* congelarGrafo(Grafo* g);
+
+/// @brief Cria um grafo editável (listas ligadas) a partir de um grafo compacto
+/// @param c Apontador para o grafo compacto
+/// @return Apontador para o novo grafo, ou NULL se falhar a alocação ou os dados forem inválidos
+Grafo* criarGrafoDeCSR(GrafoCSR* c);
+
+/// @brief Devolve o número de arestas de um vértice do grafo compacto, em O(1)
+/// @param c Apontador para o grafo compacto
+/// @param v Índice do vértice
+/// @return Número de arestas do vértice (0 se o índice for inválido)
+int grauCSR(GrafoCSR* c, int v);
+
+/// @brief Procura um vértice do grafo compacto pelas coordenadas (pesquisa binária, os vértices estão ordenados)
+/// @param c Apontador para o grafo compacto
+/// @param x Coordenada X
+/// @param y Coordenada Y
+/// @return Índice do vértice, ou -1 se não existir
+int procurarVerticeCSR(GrafoCSR* c, int x, int y);
+
+/// @brief Percurso em profundidade (DFS) iterativo sobre o grafo compacto
+/// @param c Apontador para o grafo compacto
+/// @param origem Índice do vértice onde começa o percurso
+/// @param visitado Vetor com uma posição por vértice (diferente de 0 = visitado); pode ser NULL
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices índices); pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int depthFirstTraversalCSR(GrafoCSR* c, int origem, char* visitado, int* ordem);
+
+/// @brief Liberta a memória do grafo compacto
+/// @param c Apontador para o grafo compacto
+void libertarGrafoCSR(GrafoCSR* c);
+
+#pragma endregion
+
 #pragma region Percursos
-/// @brief Realiza uma travessia em profundidade (DFS) a partir de uma antena
+/// @brief Realiza uma travessia em profundidade (DFS) a partir de uma antena, sem recursão
 /// @param origem Apontador para o vértice onde o percurso começa
-/// @return true se a travessia for realizada, false se a origem for inválida
+/// @return true se a travessia for realizada, false se a origem for inválida ou falhar a alocação
 bool depthFirstTraversal(Vertice* origem);
 
-///bool breadthFirstTraversal(Vertice* origem);
+/// @brief Realiza uma travessia em largura (BFS) a partir de uma antena
+/// @param origem Apontador para o vértice onde o percurso começa
+/// @return true se a travessia for realizada, false se a origem for inválida ou falhar a alocação
+bool breadthFirstTraversal(Vertice* origem);
+
+/// @brief Percurso em profundidade (DFS) iterativo, com pilha pré-alocada e conjunto de visitados em bits (sem resetVisitado)
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param visitar Função chamada para cada vértice descoberto (pode ser NULL); se devolver false o percurso termina
+/// @param contexto Apontador passado a visitar
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices vértices); pode ser NULL
+/// @param alcancados Conjunto de bits indexado pelo id ((numVertices + 63) / 64 palavras) onde ficam os vértices alcançados;
+///                   os vértices já marcados não são visitados; pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int percursoProfundidade(Grafo* g, Vertice* origem, VisitarVertice visitar, void* contexto, Vertice** ordem, uint64_t* alcancados);
+
+/// @brief Percurso em largura (BFS), com fila pré-alocada e conjunto de visitados em bits (sem resetVisitado)
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param visitar Função chamada para cada vértice descoberto, com a distância em arestas à origem (pode ser NULL);
+///                se devolver false o percurso termina
+/// @param contexto Apontador passado a visitar
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices vértices); pode ser NULL
+/// @param alcancados Conjunto de bits indexado pelo id ((numVertices + 63) / 64 palavras) onde ficam os vértices alcançados;
+///                   os vértices já marcados não são visitados; pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int percursoLargura(Grafo* g, Vertice* origem, VisitarVertice visitar, void* contexto, Vertice** ordem, uint64_t* alcancados);
+
+/// @brief Percurso em profundidade (DFS) iterativo sobre o grafo, que segue também as ligações implícitas
+///        (cada frequência implícita é expandida uma única vez, por isso o custo é O(V + arestas guardadas))
+/// @param g Apontador para o grafo
+/// @param origem Vértice onde o percurso começa
+/// @param ordem Vetor onde é escrita a ordem de visita (com espaço para numVertices vértices); pode ser NULL
+/// @return Número de vértices visitados, ou -1 se a origem for inválida ou falhar a alocação
+int depthFirstTraversalGrafo(Grafo* g, Vertice* origem, Vertice** ordem);
+
+#pragma endregion
+
+#pragma region Caminhos
+
+/// @brief Distâncias mínimas (soma dos pesos) de uma antena a todas as outras, pelo algoritmo de Dijkstra com uma heap binária
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param distancia Vetor indexado pelo id (numVertices posições) onde fica a distância de cada vértice (-1 se não for alcançável)
+/// @param anterior Vetor indexado pelo id onde fica o id do vértice anterior no caminho mínimo (-1 na origem e nos não alcançáveis); pode ser NULL
+/// @return true se conseguiu, false se a origem for inválida ou falhar a alocação
+bool distanciasDesde(Grafo* g, Vertice* origem, int64_t* distancia, int* anterior);
+
+/// @brief Caminho mínimo entre duas antenas, pelo algoritmo de Dijkstra (termina quando o destino é fixado)
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param destino Vértice de chegada
+/// @param caminho Vetor onde são escritos os vértices do caminho, da origem ao destino; pode ser NULL
+/// @param max Número de posições de caminho
+/// @param tamanho Apontador onde fica o número de vértices do caminho (mesmo que não caibam em caminho); pode ser NULL
+/// @return Custo do caminho, -1 se o destino não for alcançável, -2 se os vértices forem inválidos ou falhar a alocação,
+///         ou -3 se o caminho tiver mais de max vértices (nada é escrito em caminho)
+int64_t caminhoMaisCurto(Grafo* g, Vertice* origem, Vertice* destino, Vertice** caminho, int max, int* tamanho);
+
+/// @brief Caminho mínimo entre duas antenas pelo algoritmo A*, guiado pela distância em linha reta ao destino
+///        (o mesmo custo de caminhoMaisCurto, normalmente com menos vértices visitados)
+/// @param g Apontador para o grafo
+/// @param origem Vértice de partida
+/// @param destino Vértice de chegada
+/// @param caminho Vetor onde são escritos os vértices do caminho, da origem ao destino; pode ser NULL
+/// @param max Número de posições de caminho
+/// @param tamanho Apontador onde fica o número de vértices do caminho (mesmo que não caibam em caminho); pode ser NULL
+/// @return Custo do caminho, -1 se o destino não for alcançável, -2 se os vértices forem inválidos ou falhar a alocação,
+///         ou -3 se o caminho tiver mais de max vértices (nada é escrito em caminho)
+int64_t caminhoAEstrela(Grafo* g, Vertice* origem, Vertice* destino, Vertice** caminho, int max, int* tamanho);
 
 #pragma endregion
 
@@ -124,16 +591,53 @@ bool depthFirstTraversal(Vertice* origem);
 /// @return Apontador para o grafo criado ou NULL em caso de erro 
 Grafo* criarGrafoDeFicheiro(char* nomeFicheiro);
 
-/// @brief Grava num ficheiro binário os dados das antenas e das respetivas adjacências.
-/// @param h Apontador para a lista ligada de antenas.
+/// @brief Grava o grafo num ficheiro binário: cabeçalho, tabela de vértices e arestas como índices de vértices
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param g Apontador para o grafo
+/// @return true se a gravação for bem sucedida, false caso contrário.
+bool gravarFicheiroBinario(char* nomeFicheiro, Grafo* g);
+
+/// @brief Grava um grafo compacto no ficheiro binário (o mesmo formato de gravarFicheiroBinario)
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param c Apontador para o grafo compacto
 /// @return true se a gravação for bem sucedida, false caso contrário.
-bool gravarFicheiroBinario(Vertice* h);
+bool gravarFicheiroBinarioCSR(char* nomeFicheiro, GrafoCSR* c);
+
+/// @brief Lê o ficheiro binário diretamente para um grafo compacto, sem criar nós
+/// @param nomeFicheiro Caminho do ficheiro binário
+/// @param res Apontador para flag de sucesso
+/// @return Apontador para o grafo compacto, ou NULL em caso de erro (ou se o ficheiro estiver no formato antigo)
+GrafoCSR* lerFicheiroBinarioCSR(char* nomeFicheiro, bool *res);
+
+/// @brief Grava o grafo no formato comprimido (versão 4): destinos em diferenças com varints e cliques completos
+///        de uma frequência gravados só como a frequência. Lê-se com lerFicheiroBinario ou lerFicheiroBinarioCSR.
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param g Apontador para o grafo
+/// @return true se a gravação for bem sucedida, false caso contrário.
+bool gravarFicheiroBinarioComprimido(char* nomeFicheiro, Grafo* g);
+
+/// @brief Grava um grafo compacto no formato comprimido (o mesmo formato de gravarFicheiroBinarioComprimido)
+/// @param nomeFicheiro Caminho do ficheiro binário a criar
+/// @param c Apontador para o grafo compacto
+/// @return true se a gravação for bem sucedida, false caso contrário.
+bool gravarFicheiroBinarioComprimidoCSR(char* nomeFicheiro, GrafoCSR* c);
+
+/// @brief Abre um ficheiro binário (versão 3) sem o ler: as secções são usadas diretamente a partir do ficheiro mapeado
+/// @param nomeFicheiro Caminho do ficheiro binário
+/// @param verificar true para confirmar a soma de verificação e a coerência das arestas (percorre o ficheiro todo)
+/// @return Apontador para o grafo mapeado (usar g->csr com as funções do grafo compacto), ou NULL se o ficheiro
+///         não abrir, não estiver na versão 3 ou for inválido
+GrafoMapeado* abrirGrafoMapeado(char* nomeFicheiro, bool verificar);
+
+/// @brief Fecha um grafo aberto com abrirGrafoMapeado
+/// @param g Apontador para o grafo mapeado
+void fecharGrafoMapeado(GrafoMapeado* g);
 
-/// @brief Lê o ficheiro binário e reconstrói a lista de vértices com as suas adjacências
+/// @brief Lê o ficheiro binário e reconstrói o grafo com as suas adjacências (aceita também o formato antigo, sem cabeçalho)
 /// @param nomeFicheiro Caminho do ficheiro binário
 /// @param res Apontador para flag de sucesso
-/// @return Apontador para a lista reconstruída de vértices
-Vertice* lerFicheiroBinario(char* nomeFicheiro, bool *res);
+/// @return Apontador para o grafo reconstruído, ou NULL em caso de erro
+Grafo* lerFicheiroBinario(char* nomeFicheiro, bool *res);
 
 #pragma endregion
 
@@ -34,25 +34,10 @@ int main () {
 
         // 3. Criar adjacências entre antenas com a mesma frequência
     printf("\n--- Criar adjacências entre antenas ---\n");
-    Vertice* v1 = lista;
-    while (v1 != NULL) {
-        Vertice* v2 = v1->prox;
-        while (v2 != NULL) {
-            Aresta* nova = criarAdjacencia(v1, v2);
-            if (nova != NULL) {
-                inserirAdjacencia(v1, nova);
-                //printf("Adjacência criada de (%d,%d) até (%d,%d)\n", v1->x, v1->y, v2->x, v2->y);
-            } 
-
-            Aresta* nova2 = criarAdjacencia(v2, v1);
-            if (nova2 != NULL) {
-                inserirAdjacencia(v2, nova2);
-                //printf("Adjacência criada de (%d,%d) para (%d,%d)\n", v2->x, v2->y, v1->x, v1->y);
-            }
-
-            v2 = v2->prox;
-        }
-        v1 = v1->prox;
+    // Liga as antenas com a mesma frequência nos dois sentidos (só percorre os pares dentro de cada frequência)
+    if (!ligarFrequenciasGrafo(grafo, false)) {
+        printf("Erro ao criar adjacências.\n");
+        return 1;
     }
     printf("Adjacências criadas\n");
 
@@ -76,9 +61,15 @@ int main () {
         printf("DFS concluído.\n");
     }
 
+    // BFS - Percurso em largura (sem usar o campo 'visitado', por isso não precisa de resetVisitado)
+    printf("\n--- BFS (Breadth First Traversal) ---\n");
+    printf("Antenas alcançadas a partir de (%d,%d): %d\n", lista->x, lista->y,
+           percursoLargura(grafo, lista, NULL, NULL, NULL, NULL));
+
     // 6. Remover antena (por exemplo, coordenada 1,8)
     printf("\n--- Remover antena na posição (1,8) ---\n");
-    lista = removerAntena(lista, 1, 8, &resultado);
+    resultado = removerAntenaGrafo(grafo, 1, 8);
+    lista = grafo->h;
     if (resultado) {
         printf("Antena removida com sucesso.\n");
     } else {
@@ -94,7 +85,7 @@ int main () {
 
     // 8. Gravar para ficheiro binário
     printf("\n--- Gravar antenas no ficheiro binário ---\n");
-    if (gravarFicheiroBinario(lista)) {
+    if (gravarFicheiroBinario("grafo.bin", grafo)) {
         printf("Ficheiro 'grafo.bin' criado com sucesso.\n");
     } else {
         printf("Erro ao gravar ficheiro binário.\n");
@@ -103,14 +94,67 @@ int main () {
     // 9. Ler novamente do ficheiro binário
     printf("\n--- Ler ficheiro binário ---\n");
     bool resLeitura = false;
-    Vertice* listaLida = lerFicheiroBinario("grafo.bin", &resLeitura);
+    Grafo* grafoLido = lerFicheiroBinario("grafo.bin", &resLeitura);
 
     if (resLeitura) {
         printf("Antenas lidas do ficheiro binário:\n");
-        mostrarAntenas(listaLida);
+        mostrarAntenas(grafoLido->h);
     } else {
         printf("Erro ao ler do ficheiro binário.\n");
     }
 
+    printf("\n--- Grafo compacto (CSR) ---\n");
+    GrafoCSR* compacto = congelarGrafo(grafo);
+    if (compacto != NULL) {
+        printf("Vértices: %d, arestas: %d, alcançáveis a partir do primeiro: %d\n",
+               compacto->numVertices, compacto->numArestas, depthFirstTraversalCSR(compacto, 0, NULL, NULL));
+        libertarGrafoCSR(compacto);
+    }
+
+    // O ficheiro gravado é consultado no sítio, sem ser lido para memória própria
+    GrafoMapeado* mapeado = abrirGrafoMapeado("grafo.bin", true);
+    if (mapeado != NULL) {
+        printf("Ficheiro mapeado: %d vértices, %d arestas; a antena (%d,%d) é o vértice %d\n",
+               mapeado->csr.numVertices, mapeado->csr.numArestas, grafo->h->x, grafo->h->y,
+               procurarVerticeCSR(&mapeado->csr, grafo->h->x, grafo->h->y));
+        fecharGrafoMapeado(mapeado);
+    }
+
+    // Formato comprimido: os cliques das frequências ficam gravados só como a frequência
+    if (gravarFicheiroBinarioComprimido("grafo_comprimido.bin", grafo)) {
+        bool resComprimido = false;
+        GrafoCSR* lidoComprimido = lerFicheiroBinarioCSR("grafo_comprimido.bin", &resComprimido);
+        if (resComprimido) {
+            printf("Ficheiro comprimido lido: %d vértices, %d arestas\n", lidoComprimido->numVertices, lidoComprimido->numArestas);
+        }
+        libertarGrafoCSR(lidoComprimido);
+        remove("grafo_comprimido.bin");
+    }
+
+    printf("\n--- Componentes ligadas ---\n");
+    printf("O grafo tem %d componentes; a antena (%d,%d) está numa componente com %d antenas\n",
+           contarComponentes(grafo), grafo->h->x, grafo->h->y, tamanhoComponente(grafo, grafo->h));
+
+    printf("\n--- Caminho mais curto (peso = distância de Manhattan) ---\n");
+    Vertice* caminho[64];
+    int passos;
+    int64_t custo = caminhoAEstrela(grafo, grafo->h, grafo->h->adj != NULL ? grafo->h->adj->destino : grafo->h, caminho, 64, &passos);
+    printf("Custo %lld com %d antenas no caminho a partir de (%d,%d)\n", (long long)custo, passos, grafo->h->x, grafo->h->y);
+
+    printf("\n--- Procura espacial ---\n");
+    Vertice* proximas[3];
+    int encontradas = antenasMaisProximas(grafo, 5, 5, 3, 0, proximas);
+    printf("Antenas num raio de 3 de (5,5): %d; das %d mais próximas, a primeira está em (%d,%d)\n",
+           antenasNoRaio(grafo, 5, 5, 3, 0, NULL, 0), encontradas,
+           encontradas > 0 ? proximas[0]->x : -1, encontradas > 0 ? proximas[0]->y : -1);
+
+    printf("\n--- Ligações implícitas entre antenas com a mesma frequência ---\n");
+    Grafo* implicito = criarGrafoDeFicheiro("antenas.txt");
+    if (implicito != NULL && ligarFrequenciasGrafo(implicito, true)) {
+        printf("Alcançáveis a partir da primeira antena: %d (sem arestas guardadas)\n",
+               depthFirstTraversalGrafo(implicito, implicito->h, NULL));
+    }
+    libertarGrafo(implicito);
+
     return 0;
 }
\ No newline at end of file